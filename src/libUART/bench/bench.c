@@ -0,0 +1,545 @@
+/**
+ *
+ * File Name: bench/bench.c
+ * Title    : libUART pseudo terminal loopback benchmark
+ * Project  : libUART
+ * Author   : Copyright (C) 2018-2020 Johannes Krottmayer <krjdev@gmail.com>
+ * Created  : 2026-10-19
+ * Modified :
+ * Revised  :
+ * Version  : 0.1.0.0
+ * License  : ISC (see file LICENSE.txt)
+ *
+ * NOTE: This code is currently below version 1.0, and therefore is considered
+ * to be lacking in some functionality or documentation, or may not be fully
+ * tested. Nonetheless, you can expect most functions to work.
+ *
+ */
+
+/*
+ * Runs the hot paths of libUART against the master side of a pseudo
+ * terminal, so no hardware is needed. Every result is printed as one
+ * JSON object per line on stdout:
+ *
+ *   rx/tx  bulk throughput through libUART_recv()/libUART_send()
+ *   rtt    small message round trip against an echo thread
+ *   reads  read() calls per received byte for libUART_getc() and
+ *          libUART_recv() at different buffer sizes
+ *   open   cost of opening and configuring many ports one after the
+ *          other with libUART_open() and in parallel with
+ *          libUART_open_many()
+ *
+ * Usage: libUART_bench [-n bytes] [-r round trips] [-p ports]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <poll.h>
+#include <pty.h>
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "../libUART.h"
+
+#define BENCH_BAUD          115200
+#define BENCH_BYTES         (4 * 1024 * 1024)
+#define BENCH_ROUND_TRIPS   2000
+#define BENCH_MSG_SIZE      16
+#define BENCH_CHUNK_SIZE    4096
+#define BENCH_PORTS         64
+
+struct bench_pty {
+    int master;
+    int slave;
+    char name[64];
+    uart_t *uart;
+    struct pollfd pfd;
+};
+
+struct bench_peer {
+    int fd;
+    long long bytes;
+};
+
+static long long now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long) ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+/* printable bytes only, the pty still translates CR on input */
+static void fill_pattern(char *buf, int len)
+{
+    int i;
+
+    for (i = 0; i < len; i++)
+        buf[i] = 'a' + (i % 26);
+}
+
+static int bench_open(struct bench_pty *p)
+{
+    uart_t *uart[1];
+
+    if (openpty(&p->master, &p->slave, p->name, NULL, NULL) == -1) {
+        perror("openpty");
+        return -1;
+    }
+
+    p->uart = libUART_open(p->name, BENCH_BAUD, "8N1N");
+
+    if (!p->uart) {
+        close(p->master);
+        close(p->slave);
+        return -1;
+    }
+
+    uart[0] = p->uart;
+    libUART_get_pollfds(uart, 1, &p->pfd);
+    return 0;
+}
+
+static void bench_close(struct bench_pty *p)
+{
+    libUART_close(p->uart);
+    close(p->master);
+    close(p->slave);
+}
+
+static int wait_port(struct bench_pty *p, short events)
+{
+    p->pfd.events = events;
+
+    while (poll(&p->pfd, 1, -1) == -1) {
+        if (errno != EINTR) {
+            perror("poll");
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+static int write_all(int fd, const char *buf, int len)
+{
+    int ret;
+
+    while (len > 0) {
+        ret = write(fd, buf, len);
+
+        if (ret == -1) {
+            if (errno == EINTR)
+                continue;
+
+            return -1;
+        }
+
+        buf += ret;
+        len -= ret;
+    }
+
+    return 0;
+}
+
+static void *peer_writer(void *arg)
+{
+    struct bench_peer *peer = (struct bench_peer *) arg;
+    char buf[BENCH_CHUNK_SIZE];
+    long long left = peer->bytes;
+    int n;
+
+    fill_pattern(buf, sizeof(buf));
+
+    while (left > 0) {
+        n = left < (long long) sizeof(buf) ? (int) left : (int) sizeof(buf);
+
+        if (write_all(peer->fd, buf, n) == -1)
+            break;
+
+        left -= n;
+    }
+
+    return NULL;
+}
+
+static void *peer_reader(void *arg)
+{
+    struct bench_peer *peer = (struct bench_peer *) arg;
+    char buf[BENCH_CHUNK_SIZE];
+    long long left = peer->bytes;
+    int ret;
+
+    while (left > 0) {
+        ret = read(peer->fd, buf, sizeof(buf));
+
+        if (ret <= 0) {
+            if (ret == -1 && errno == EINTR)
+                continue;
+
+            break;
+        }
+
+        left -= ret;
+    }
+
+    return NULL;
+}
+
+static void *peer_echo(void *arg)
+{
+    struct bench_peer *peer = (struct bench_peer *) arg;
+    char buf[BENCH_CHUNK_SIZE];
+    long long left = peer->bytes;
+    int ret;
+
+    while (left > 0) {
+        ret = read(peer->fd, buf, sizeof(buf));
+
+        if (ret <= 0) {
+            if (ret == -1 && errno == EINTR)
+                continue;
+
+            break;
+        }
+
+        if (write_all(peer->fd, buf, ret) == -1)
+            break;
+
+        left -= ret;
+    }
+
+    return NULL;
+}
+
+/* receive 'bytes' with libUART_recv() (bufsize > 0) or libUART_getc() */
+static int recv_bytes(struct bench_pty *p, long long bytes, int bufsize)
+{
+    char buf[BENCH_CHUNK_SIZE];
+    int ret;
+
+    while (bytes > 0) {
+        if (wait_port(p, POLLIN) == -1)
+            return -1;
+
+        do {
+            if (bufsize > 0)
+                ret = libUART_recv(p->uart, buf, bufsize);
+            else
+                ret = libUART_getc(p->uart, buf);
+
+            if (ret == -1)
+                return -1;
+
+            bytes -= ret;
+        } while (ret > 0 && bytes > 0);
+    }
+
+    return 0;
+}
+
+static int bench_rx(long long bytes)
+{
+    struct bench_pty p;
+    struct bench_peer peer;
+    pthread_t thread;
+    long long t0;
+    long long ns;
+    int ret;
+
+    if (bench_open(&p) == -1)
+        return -1;
+
+    peer.fd = p.master;
+    peer.bytes = bytes;
+    t0 = now_ns();
+    pthread_create(&thread, NULL, peer_writer, &peer);
+    ret = recv_bytes(&p, bytes, BENCH_CHUNK_SIZE);
+    ns = now_ns() - t0;
+    pthread_join(thread, NULL);
+    bench_close(&p);
+
+    if (ret == -1)
+        return -1;
+
+    printf("{\"bench\":\"rx\",\"bytes\":%lld,\"ns\":%lld,\"mib_s\":%.2f}\n",
+           bytes, ns, bytes / (ns / 1e9) / (1024.0 * 1024.0));
+    return 0;
+}
+
+static int bench_tx(long long bytes)
+{
+    struct bench_pty p;
+    struct bench_peer peer;
+    struct uart_stats st;
+    char buf[BENCH_CHUNK_SIZE];
+    pthread_t thread;
+    long long left = bytes;
+    long long t0;
+    long long ns;
+    int ret = 0;
+    int n;
+
+    if (bench_open(&p) == -1)
+        return -1;
+
+    fill_pattern(buf, sizeof(buf));
+    peer.fd = p.master;
+    peer.bytes = bytes;
+    t0 = now_ns();
+    pthread_create(&thread, NULL, peer_reader, &peer);
+
+    /* a full kernel buffer is an error for libUART_send(), wait first */
+    while (left > 0) {
+        if (wait_port(&p, POLLOUT) == -1) {
+            ret = -1;
+            break;
+        }
+
+        n = left < (long long) sizeof(buf) ? (int) left : (int) sizeof(buf);
+        ret = libUART_send(p.uart, buf, n);
+
+        if (ret == -1)
+            break;
+
+        left -= ret;
+    }
+
+    pthread_join(thread, NULL);
+    ns = now_ns() - t0;
+    libUART_get_stats(p.uart, &st);
+    bench_close(&p);
+
+    if (ret == -1)
+        return -1;
+
+    printf("{\"bench\":\"tx\",\"bytes\":%lld,\"ns\":%lld,\"mib_s\":%.2f,"
+           "\"write_calls\":%llu,\"short_writes\":%llu}\n",
+           bytes, ns, bytes / (ns / 1e9) / (1024.0 * 1024.0),
+           st.write_calls, st.short_writes);
+    return 0;
+}
+
+static int bench_rtt(int round_trips)
+{
+    struct bench_pty p;
+    struct bench_peer peer;
+    struct uart_hist first;
+    struct uart_hist final;
+    char msg[BENCH_MSG_SIZE];
+    pthread_t thread;
+    int ret = 0;
+    int i;
+
+    if (bench_open(&p) == -1)
+        return -1;
+
+    if (libUART_set_latency(p.uart, 1) == -1) {
+        bench_close(&p);
+        return -1;
+    }
+
+    fill_pattern(msg, sizeof(msg));
+    peer.fd = p.master;
+    peer.bytes = (long long) round_trips * sizeof(msg);
+    pthread_create(&thread, NULL, peer_echo, &peer);
+
+    for (i = 0; i < round_trips && ret != -1; i++) {
+        libUART_lat_begin(p.uart, 0);
+        ret = libUART_send(p.uart, msg, sizeof(msg));
+
+        if (ret != -1)
+            ret = recv_bytes(&p, sizeof(msg), sizeof(msg));
+
+        libUART_lat_end(p.uart);
+    }
+
+    pthread_join(thread, NULL);
+    libUART_get_latency(p.uart, 0, UART_LAT_FIRST_BYTE, &first);
+    libUART_get_latency(p.uart, 0, UART_LAT_FINAL, &final);
+    bench_close(&p);
+
+    if (ret == -1)
+        return -1;
+
+    printf("{\"bench\":\"rtt\",\"msg\":%d,\"samples\":%llu,"
+           "\"first_p50_us\":%lld,\"first_p99_us\":%lld,"
+           "\"p50_us\":%lld,\"p99_us\":%lld,\"p999_us\":%lld,"
+           "\"max_us\":%lld}\n",
+           BENCH_MSG_SIZE, final.count,
+           libUART_hist_percentile(&first, 50.0),
+           libUART_hist_percentile(&first, 99.0),
+           libUART_hist_percentile(&final, 50.0),
+           libUART_hist_percentile(&final, 99.0),
+           libUART_hist_percentile(&final, 99.9),
+           final.max);
+    return 0;
+}
+
+static int bench_reads(long long bytes, int bufsize)
+{
+    struct bench_pty p;
+    struct bench_peer peer;
+    struct uart_stats st;
+    pthread_t thread;
+    long long t0;
+    long long ns;
+    int ret;
+
+    if (bench_open(&p) == -1)
+        return -1;
+
+    peer.fd = p.master;
+    peer.bytes = bytes;
+    t0 = now_ns();
+    pthread_create(&thread, NULL, peer_writer, &peer);
+    ret = recv_bytes(&p, bytes, bufsize);
+    ns = now_ns() - t0;
+    pthread_join(thread, NULL);
+    libUART_get_stats(p.uart, &st);
+    bench_close(&p);
+
+    if (ret == -1)
+        return -1;
+
+    printf("{\"bench\":\"reads\",\"api\":\"%s\",\"bufsize\":%d,"
+           "\"bytes\":%lld,\"ns\":%lld,\"read_calls\":%llu,"
+           "\"empty_reads\":%llu,\"calls_per_byte\":%.4f}\n",
+           bufsize > 0 ? "recv" : "getc", bufsize > 0 ? bufsize : 1,
+           bytes, ns, st.read_calls, st.empty_reads,
+           (double) st.read_calls / bytes);
+    return 0;
+}
+
+static int bench_open_ports(int ports)
+{
+    const char **devs;
+    uart_t **uart;
+    int *status;
+    int *master;
+    int *slave;
+    char (*name)[64];
+    long long t0;
+    long long ns;
+    int opened = 0;
+    int ret = -1;
+    int i;
+
+    devs = (const char **) calloc(ports, sizeof(*devs));
+    uart = (uart_t **) calloc(ports, sizeof(*uart));
+    status = (int *) calloc(ports, sizeof(*status));
+    master = (int *) calloc(ports, sizeof(*master));
+    slave = (int *) calloc(ports, sizeof(*slave));
+    name = (char (*)[64]) calloc(ports, sizeof(*name));
+
+    if (!devs || !uart || !status || !master || !slave || !name) {
+        fprintf(stderr, "out of memory\n");
+        goto out;
+    }
+
+    for (i = 0; i < ports; i++) {
+        if (openpty(&master[i], &slave[i], name[i], NULL, NULL) == -1) {
+            perror("openpty");
+            ports = i;
+            goto out;
+        }
+
+        devs[i] = name[i];
+    }
+
+    t0 = now_ns();
+
+    for (i = 0; i < ports; i++) {
+        uart[i] = libUART_open(devs[i], BENCH_BAUD, "8N1N");
+        opened += uart[i] != NULL;
+    }
+
+    ns = now_ns() - t0;
+
+    for (i = 0; i < ports; i++)
+        libUART_close(uart[i]);
+
+    printf("{\"bench\":\"open\",\"mode\":\"serial\",\"ports\":%d,"
+           "\"opened\":%d,\"ns\":%lld,\"ns_per_port\":%lld}\n",
+           ports, opened, ns, ns / ports);
+
+    t0 = now_ns();
+    opened = libUART_open_many(devs, ports, BENCH_BAUD, "8N1N", uart, status);
+    ns = now_ns() - t0;
+
+    for (i = 0; i < ports; i++)
+        libUART_close(uart[i]);
+
+    printf("{\"bench\":\"open\",\"mode\":\"parallel\",\"ports\":%d,"
+           "\"opened\":%d,\"ns\":%lld,\"ns_per_port\":%lld}\n",
+           ports, opened, ns, ns / ports);
+    ret = opened == ports ? 0 : -1;
+
+out:
+    for (i = 0; master && slave && i < ports; i++) {
+        close(master[i]);
+        close(slave[i]);
+    }
+
+    free(devs);
+    free(uart);
+    free(status);
+    free(master);
+    free(slave);
+    free(name);
+    return ret;
+}
+
+int main(int argc, char **argv)
+{
+    static const int bufsizes[] = { 1, 16, 64, 256, 1024, 4096 };
+    long long bytes = BENCH_BYTES;
+    int round_trips = BENCH_ROUND_TRIPS;
+    int ports = BENCH_PORTS;
+    int ret = 0;
+    int opt;
+    int i;
+
+    while ((opt = getopt(argc, argv, "n:r:p:")) != -1) {
+        switch (opt) {
+        case 'n':
+            bytes = atoll(optarg);
+            break;
+        case 'r':
+            round_trips = atoi(optarg);
+            break;
+        case 'p':
+            ports = atoi(optarg);
+            break;
+        default:
+            fprintf(stderr, "usage: %s [-n bytes] [-r round trips] "
+                    "[-p ports]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    if (bytes <= 0 || round_trips <= 0 || ports <= 0) {
+        fprintf(stderr, "%s: invalid argument\n", argv[0]);
+        return 1;
+    }
+
+    /* short writes are expected here, keep the output machine-readable */
+    libUART_set_error(0);
+    setvbuf(stdout, NULL, _IOLBF, 0);
+    ret |= bench_rx(bytes);
+    ret |= bench_tx(bytes);
+    ret |= bench_rtt(round_trips);
+
+    /* getc() is far slower, keep its run short */
+    ret |= bench_reads(bytes / 16, 0);
+
+    for (i = 0; i < (int) (sizeof(bufsizes) / sizeof(bufsizes[0])); i++)
+        ret |= bench_reads(bytes / 16, bufsizes[i]);
+
+    ret |= bench_open_ports(ports);
+
+    return ret ? 1 : 0;
+}
@@ -31,6 +31,8 @@ extern "C"
 #else
 #define LIBUART_API __declspec(dllimport)
 #endif
+#elif __unix__
+#include <poll.h>
 #endif
 
 struct _uart;
@@ -110,11 +112,171 @@ enum e_pins {
 #define UART_PIN_LOW        0
 #define UART_PIN_HIGH       1
 
+#ifdef __unix__
+enum e_error {
+    UART_ERR_NONE,
+    UART_ERR_INVAL,     /* invalid argument or setting */
+    UART_ERR_SYS,       /* system call failed, see sys_errno */
+    UART_ERR_STATE,     /* not possible in the current state of the port */
+    UART_ERR_IO         /* incomplete transfer or lost device */
+};
+
+struct uart_error {
+    int code;                   /* UART_ERR_* */
+    int sys_errno;              /* errno of a failed system call */
+    const char *msg;            /* static description */
+};
+
+typedef void (*uart_log_cb)(const struct uart_error *err, void *arg);
+
+struct uart_stats {
+    unsigned long long rx_bytes;        /* bytes received */
+    unsigned long long tx_bytes;        /* bytes transmitted */
+    unsigned long long read_calls;      /* read() system calls */
+    unsigned long long write_calls;     /* write()/writev() system calls */
+    unsigned long long short_writes;    /* writes not taking all bytes */
+    unsigned long long empty_reads;     /* reads without data (EAGAIN) */
+    unsigned long long reconfigs;       /* line setting changes */
+    long long elapsed_ms;               /* time since open or reset */
+    double rx_utilization;              /* share of the line capacity */
+    double tx_utilization;
+};
+
+#define UART_LAT_CLASSES    8   /* command classes per port */
+#define UART_LAT_FIRST_BYTE 0   /* command written to first answer byte */
+#define UART_LAT_FINAL      1   /* command written to final result */
+#define UART_LAT_KINDS      2
+
+#define UART_HIST_SUB_BITS  4
+#define UART_HIST_BUCKETS   544 /* values up to 2^37 us */
+
+/* log-bucket latency histogram, values in microseconds */
+struct uart_hist {
+    unsigned long long count;
+    long long min;
+    long long max;
+    unsigned long long bucket[UART_HIST_BUCKETS];
+};
+
+/* driver interrupt counters (TIOCGICOUNT) */
+struct uart_icount {
+    unsigned int rx;            /* characters received */
+    unsigned int tx;            /* characters transmitted */
+    unsigned int frame;         /* framing errors */
+    unsigned int parity;        /* parity errors */
+    unsigned int overrun;       /* UART FIFO overruns */
+    unsigned int brk;           /* break conditions */
+    unsigned int buf_overrun;   /* TTY flip buffer overruns */
+};
+
+typedef void (*uart_icount_cb)(uart_t *uart, const struct uart_icount *delta,
+                               void *arg);
+
+struct _uart_sim;
+
+typedef struct _uart_sim uart_sim_t;
+
+struct _uart_mgr;
+
+typedef struct _uart_mgr uart_mgr_t;
+
+struct _uart_pool;
+
+typedef struct _uart_pool uart_pool_t;
+
+typedef void (*uart_pool_cb)(uart_t *uart, void *ctx);
+
+enum e_hotplug {
+    UART_HOTPLUG_REMOVED,       /* device node removed, port unusable */
+    UART_HOTPLUG_REOPENED       /* device back, port reopened */
+};
+
+typedef void (*uart_hotplug_cb)(uart_t *uart, int event, void *arg);
+
+typedef void (*uart_release_cb)(void *arg);
+
+struct _uart_bridge;
+
+typedef struct _uart_bridge uart_bridge_t;
+
+/* flags of libUART_bridge_create() */
+#define UART_BRIDGE_RFC2217 0x01    /* telnet COM port control (RFC 2217) */
+
+struct _uart_share;
+
+typedef struct _uart_share uart_share_t;
+
+/* unit of transmit data a pty of an uart_share_t sends at once */
+enum e_share {
+    UART_SHARE_FRAME,           /* the data of one read() of the pty */
+    UART_SHARE_LINE             /* a line ending with '\n' */
+};
+
+/* worker threads of an uart_pool_t */
+struct uart_pool_cfg {
+    int workers;                /* number of worker threads (shards) */
+    const int *cpus;            /* CPU of each worker, NULL to not pin */
+    int priority;               /* SCHED_FIFO priority, 0 for the default */
+    int slab_size;              /* buffer pool of each shard, see */
+    int slabs;                  /* libUART_mgr_create() */
+    int budget;
+};
+
+/* load of one worker of an uart_pool_t */
+struct uart_shard_load {
+    int cpu;                            /* pinned CPU, -1 if not pinned */
+    int ports;                          /* ports owned by the worker */
+    unsigned long long rx_bytes;        /* bytes received */
+    unsigned long long tx_bytes;        /* bytes transmitted */
+    unsigned long long wakeups;         /* polls returning ready ports */
+    unsigned long long callbacks;       /* callback invocations */
+    long long elapsed_ms;               /* time since the pool was created */
+    double utilization;                 /* share of time not spent waiting */
+};
+
+/* progress of a replayed capture */
+struct uart_replay_stats {
+    unsigned long long rx_bytes;        /* recorded bytes served so far */
+    unsigned long long rx_total;        /* recorded bytes to serve */
+    unsigned long long tx_bytes;        /* bytes written by the application */
+    unsigned long long tx_total;        /* recorded bytes written */
+    unsigned long long tx_mismatch;     /* bytes differing from the record */
+    long long tx_first_mismatch;        /* offset of the first, -1 if none */
+    int done;                           /* all recorded bytes served */
+};
+
+/* serial device found by libUART_enumerate() */
+struct uart_port_info {
+    char dev[64];               /* device node, e.g. /dev/ttyUSB0 */
+    char driver[64];            /* kernel driver, e.g. ftdi_sio */
+    char by_id[256];            /* /dev/serial/by-id link, empty if none */
+    char serial[128];           /* USB serial number, empty if none */
+    int vid;                    /* USB vendor ID, -1 if not USB */
+    int pid;                    /* USB product ID, -1 if not USB */
+    int interface;              /* USB interface number, -1 if not USB */
+};
+
+/* receive times on the CLOCK_MONOTONIC_RAW clock, see libUART_recv_ts() */
+struct uart_rx_ts {
+    long long rx_ns;            /* data read, or the wakeup that read it */
+    long long first_ns;         /* estimated arrival of the first byte */
+};
+
+/* impairments of a simulated line, all zero for a clean line */
+struct uart_sim_cfg {
+    long latency_us;            /* fixed delay added to every byte */
+    long jitter_us;             /* random extra delay (0 - jitter_us) */
+    double bit_error_rate;      /* probability of a flipped data bit */
+    unsigned int seed;          /* seed of the jitter and error generator */
+};
+#endif
+
 #ifdef __unix__
 extern uart_t *libUART_open(const char *dev, int baud, const char *opt);
 extern void libUART_close(uart_t *uart);
 extern int libUART_send(uart_t *uart, char *send_buf, int len);
 extern int libUART_recv(uart_t *uart, char *recv_buf, int len);
+extern int libUART_recv_ts(uart_t *uart, char *recv_buf, int len, struct uart_rx_ts *ts);
 extern int libUART_puts(uart_t *uart, char *msg);
 extern int libUART_getc(uart_t *uart, char *c);
 extern int libUART_flush(uart_t *uart);
@@ -122,6 +284,7 @@ extern int libUART_set_baud(uart_t *uart, int baud);
 extern int libUART_get_baud(uart_t *uart, int *baud);
 extern int libUART_get_fd(uart_t *uart, int *fd);
 extern int libUART_get_dev(uart_t *uart, char **dev);
+extern int libUART_get_pty_name(uart_t *uart, char **name);
 extern int libUART_set_databits(uart_t *uart, int data_bits);
 extern int libUART_get_databits(uart_t *uart, int *data_bits);
 extern int libUART_set_parity(uart_t *uart, int parity);
@@ -133,6 +296,61 @@ extern int libUART_get_flowctrl(uart_t *uart, int *flow_ctrl);
 extern int libUART_set_pin(uart_t *uart, int pin, int state);
 extern int libUART_get_pin(uart_t *uart, int pin, int *state);
 extern int libUART_get_bytes_available(uart_t *uart, int *num);
+extern int libUART_reader_start(uart_t *uart, int chunk_size, int chunks);
+extern int libUART_reader_stop(uart_t *uart);
+extern int libUART_reader_peek(uart_t *uart, char **data, int *len);
+extern int libUART_reader_release(uart_t *uart);
+extern int libUART_set_txqueue(uart_t *uart, int enable);
+extern int libUART_tx_drain(uart_t *uart);
+extern int libUART_get_tx_pending(uart_t *uart, int *bytes);
+extern int libUART_get_pollfds(uart_t **uart, int num, struct pollfd *fds);
+extern int libUART_on_readable(uart_t *uart);
+extern int libUART_on_writable(uart_t *uart);
+extern int libUART_get_stats(uart_t *uart, struct uart_stats *stats);
+extern int libUART_reset_stats(uart_t *uart);
+extern int libUART_set_latency(uart_t *uart, int enable);
+extern int libUART_lat_begin(uart_t *uart, int cls);
+extern int libUART_lat_end(uart_t *uart);
+extern int libUART_get_latency(uart_t *uart, int cls, int kind, struct uart_hist *hist);
+extern int libUART_reset_latency(uart_t *uart);
+extern int libUART_hist_merge(struct uart_hist *dst, const struct uart_hist *src);
+extern long long libUART_hist_percentile(const struct uart_hist *hist, double p);
+extern int libUART_get_icount(uart_t *uart, struct uart_icount *total, struct uart_icount *delta);
+extern int libUART_set_icount_threshold(uart_t *uart, const struct uart_icount *threshold, uart_icount_cb cb, void *arg);
+extern uart_sim_t *libUART_sim_open(int baud, const char *opt, const struct uart_sim_cfg *cfg);
+extern void libUART_sim_close(uart_sim_t *sim);
+extern int libUART_sim_get_dev(uart_sim_t *sim, int end, char **dev);
+extern int libUART_trace_dump(const char *path);
+extern int libUART_last_error(struct uart_error *err);
+extern int libUART_capture_start(uart_t *uart, const char *path, long seg_size, int segments);
+extern int libUART_capture_stop(uart_t *uart);
+extern uart_t *libUART_replay_open(const char *path, double speed, int compare_tx);
+extern int libUART_replay_get_stats(uart_t *uart, struct uart_replay_stats *stats);
+extern int libUART_open_many(const char **devs, int num, int baud, const char *opt, uart_t **uart, int *status);
+extern uart_mgr_t *libUART_mgr_create(int slab_size, int slabs, int budget);
+extern void libUART_mgr_destroy(uart_mgr_t *mgr);
+extern int libUART_mgr_add(uart_mgr_t *mgr, uart_t *uart);
+extern int libUART_mgr_remove(uart_mgr_t *mgr, uart_t *uart);
+extern int libUART_mgr_poll(uart_mgr_t *mgr, uart_t **ready, int max, int timeout_ms);
+extern uart_pool_t *libUART_pool_create(const struct uart_pool_cfg *cfg, uart_pool_cb cb);
+extern void libUART_pool_destroy(uart_pool_t *pool);
+extern int libUART_pool_add(uart_pool_t *pool, uart_t *uart, int shard, void *ctx);
+extern int libUART_pool_remove(uart_pool_t *pool, uart_t *uart);
+extern int libUART_pool_move(uart_pool_t *pool, uart_t *uart, int shard);
+extern int libUART_pool_get_shard(uart_pool_t *pool, uart_t *uart, int *shard);
+extern int libUART_pool_get_load(uart_pool_t *pool, int shard, struct uart_shard_load *load);
+extern int libUART_enumerate(struct uart_port_info *ports, int max);
+extern int libUART_hotplug_watch(uart_t *uart, uart_hotplug_cb cb, void *arg);
+extern int libUART_hotplug_unwatch(uart_t *uart);
+extern int libUART_set_reconnect(uart_t *uart, int min_ms, int max_ms);
+extern int libUART_get_reconnecting(uart_t *uart, int *state);
+extern uart_bridge_t *libUART_bridge_create(uart_t *uart, const char *addr, int flags);
+extern void libUART_bridge_destroy(uart_bridge_t *bridge);
+extern uart_share_t *libUART_share_create(uart_t *uart, int num, int mode);
+extern void libUART_share_destroy(uart_share_t *share);
+extern const char *libUART_share_get_name(uart_share_t *share, int idx);
+extern int libUART_broadcast(uart_t **uart, int num, const char *send_buf, int len, uart_release_cb release, void *arg, int *status);
+extern void libUART_set_log_callback(uart_log_cb cb, void *arg);
 extern void libUART_set_error(int enable);
 extern char *libUART_get_libname(void);
 extern char *libUART_get_libversion(void);
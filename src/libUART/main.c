@@ -22,6 +22,23 @@
 #ifdef __unix__
 #include "unix/uart.h"
 #include "unix/error.h"
+#include "unix/reader.h"
+#include "unix/txq.h"
+#include "unix/stats.h"
+#include "unix/latency.h"
+#include "unix/sim.h"
+#include "unix/trace.h"
+#include "unix/capture.h"
+#include "unix/replay.h"
+#include "unix/bulk.h"
+#include "unix/manager.h"
+#include "unix/pool.h"
+#include "unix/enum.h"
+#include "unix/hotplug.h"
+#include "unix/reconnect.h"
+#include "unix/bridge.h"
+#include "unix/share.h"
+#include "unix/backend.h"
 #elif _WIN32
 #include <Windows.h>
 #include "win32/uart.h"
@@ -121,10 +138,10 @@ uart_t *libUART_open(const char *dev, int baud, const char *opt)
 {
     uart_t *p;
     
-    p = (uart_t *) malloc(sizeof(uart_t));
+    p = (uart_t *) calloc(1, sizeof(uart_t));
     
     if (!p) {
-        error("malloc() failed", 1);
+        error("calloc() failed", 1);
         return NULL;
     }
     
@@ -142,6 +159,7 @@ uart_t *libUART_open(const char *dev, int baud, const char *opt)
     }
     
     if (!uart_baud_valid(baud)) {
+        error("invalid baud rate", 0);
         free(p);
         return NULL;
     }
@@ -181,6 +199,14 @@ int libUART_send(uart_t *uart, char *send_buf, int len)
         return -1;
     }
     
+#ifdef __unix__
+    if (uart->txq)
+        return txq_send(uart, send_buf, len);
+    
+    if (uart->mgr)
+        return mgr_send(uart, send_buf, len);
+#endif
+    
     return uart_send(uart, send_buf, len);
 }
 
@@ -201,9 +227,50 @@ int libUART_recv(uart_t *uart, char *recv_buf, int len)
         return -1;
     }
     
+#ifdef __unix__
+    if (uart->reader)
+        return reader_recv(uart, recv_buf, len, NULL);
+    
+    if (uart->mgr)
+        return mgr_recv(uart, recv_buf, len, NULL);
+#endif
+    
     return uart_recv(uart, recv_buf, len);
 }
 
+#ifdef __unix__
+int libUART_recv_ts(uart_t *uart, char *recv_buf, int len, struct uart_rx_ts *ts)
+{
+    if (!uart) {
+        error("invalid <uart_t> object", 0);
+        return -1;
+    }
+    
+    if (!recv_buf) {
+        error("invalid receive buffer", 0);
+        return -1;
+    }
+    
+    if (len < 1) {
+        error("invalid receive buffer length", 0);
+        return -1;
+    }
+    
+    if (!ts) {
+        error("invalid <struct uart_rx_ts> pointer", 0);
+        return -1;
+    }
+    
+    if (uart->reader)
+        return reader_recv(uart, recv_buf, len, ts);
+    
+    if (uart->mgr)
+        return mgr_recv(uart, recv_buf, len, ts);
+    
+    return uart_recv_ts(uart, recv_buf, len, ts);
+}
+#endif
+
 int libUART_puts(uart_t *uart, char *msg)
 {
     if (!uart) {
@@ -216,6 +283,14 @@ int libUART_puts(uart_t *uart, char *msg)
         return -1;
     }
     
+#ifdef __unix__
+    if (uart->txq)
+        return txq_send(uart, msg, strlen(msg));
+    
+    if (uart->mgr)
+        return mgr_send(uart, msg, strlen(msg));
+#endif
+    
     return uart_send(uart, msg, strlen(msg));
 }
 
@@ -234,6 +309,13 @@ int libUART_getc(uart_t *uart, char *c)
         return -1;
     }
     
+#ifdef __unix__
+    if (uart->reader)
+        ret = reader_recv(uart, &buf[0], 1, NULL);
+    else if (uart->mgr)
+        ret = mgr_recv(uart, &buf[0], 1, NULL);
+    else
+#endif
     ret = uart_recv(uart, &buf[0], 1);
     (*c) = buf[0];
     return ret;
@@ -326,6 +408,30 @@ int libUART_get_dev(uart_t *uart, char **dev)
     return 0;
 }
 
+#ifdef __unix__
+int libUART_get_pty_name(uart_t *uart, char **name)
+{
+    if (!uart) {
+        error("invalid <uart_t> object", 0);
+        return -1;
+    }
+    
+    if (!name) {
+        error("invalid <char> pointer to pointer", 0);
+        return -1;
+    }
+    
+    (*name) = (char *) backend_pty_name(uart);
+    
+    if (!(*name)) {
+        error_code(UART_ERR_STATE, "port is not a pseudo terminal");
+        return -1;
+    }
+    
+    return 0;
+}
+#endif
+
 int libUART_set_databits(uart_t *uart, int data_bits)
 {
     if (!uart) {
@@ -474,6 +580,1075 @@ int libUART_get_bytes_available(uart_t *uart, int *num)
     return uart_get_bytes(uart, num);
 }
 
+#ifdef __unix__
+int libUART_reader_start(uart_t *uart, int chunk_size, int chunks)
+{
+    if (!uart) {
+        error("invalid <uart_t> object", 0);
+        return -1;
+    }
+    
+    if (chunk_size < 1) {
+        error("invalid chunk size", 0);
+        return -1;
+    }
+    
+    if (chunks < 2 || (chunks & (chunks - 1))) {
+        error("invalid number of chunks (must be a power of two)", 0);
+        return -1;
+    }
+    
+    if (uart->mgr) {
+        error_code(UART_ERR_STATE, "port is managed");
+        return -1;
+    }
+    
+    return reader_start(uart, chunk_size, chunks);
+}
+
+int libUART_reader_stop(uart_t *uart)
+{
+    if (!uart) {
+        error("invalid <uart_t> object", 0);
+        return -1;
+    }
+    
+    if (!uart->reader) {
+        error_code(UART_ERR_STATE, "receive ring not enabled");
+        return -1;
+    }
+    
+    uart_reopen_lock();
+    reader_stop(uart);
+    uart_reopen_unlock();
+    return 0;
+}
+
+int libUART_reader_peek(uart_t *uart, char **data, int *len)
+{
+    if (!uart) {
+        error("invalid <uart_t> object", 0);
+        return -1;
+    }
+    
+    if (!data) {
+        error("invalid <char> pointer to pointer", 0);
+        return -1;
+    }
+    
+    if (!len) {
+        error("invalid <int> pointer", 0);
+        return -1;
+    }
+    
+    if (!uart->reader) {
+        error_code(UART_ERR_STATE, "receive ring not enabled");
+        return -1;
+    }
+    
+    return reader_peek(uart, data, len);
+}
+
+int libUART_reader_release(uart_t *uart)
+{
+    if (!uart) {
+        error("invalid <uart_t> object", 0);
+        return -1;
+    }
+    
+    if (!uart->reader) {
+        error_code(UART_ERR_STATE, "receive ring not enabled");
+        return -1;
+    }
+    
+    return reader_release(uart);
+}
+
+int libUART_set_txqueue(uart_t *uart, int enable)
+{
+    if (!uart) {
+        error("invalid <uart_t> object", 0);
+        return -1;
+    }
+    
+    if (enable) {
+        if (uart->txq)
+            return 0;
+        
+        if (uart->mgr) {
+            error_code(UART_ERR_STATE, "port is managed");
+            return -1;
+        }
+        
+        return txq_create(uart);
+    }
+    
+    if (!uart->txq)
+        return 0;
+    
+    if (txq_pending(uart) > 0) {
+        error_code(UART_ERR_STATE, "transmit queue not empty");
+        return -1;
+    }
+    
+    txq_destroy(uart);
+    return 0;
+}
+
+int libUART_tx_drain(uart_t *uart)
+{
+    if (!uart) {
+        error("invalid <uart_t> object", 0);
+        return -1;
+    }
+    
+    if (!uart->txq) {
+        error_code(UART_ERR_STATE, "transmit queue not enabled");
+        return -1;
+    }
+    
+    return txq_drain(uart);
+}
+
+int libUART_get_tx_pending(uart_t *uart, int *bytes)
+{
+    if (!uart) {
+        error("invalid <uart_t> object", 0);
+        return -1;
+    }
+    
+    if (!bytes) {
+        error("invalid <int> pointer", 0);
+        return -1;
+    }
+    
+    if (uart->txq)
+        (*bytes) = txq_pending(uart);
+    else if (uart->mgr)
+        (*bytes) = mgr_tx_pending(uart);
+    else
+        (*bytes) = 0;
+    
+    return 0;
+}
+
+int libUART_get_pollfds(uart_t **uart, int num, struct pollfd *fds)
+{
+    int i;
+    
+    if (!uart) {
+        error("invalid <uart_t> array", 0);
+        return -1;
+    }
+    
+    if (!fds) {
+        error("invalid <struct pollfd> pointer", 0);
+        return -1;
+    }
+    
+    for (i = 0; i < num; i++) {
+        if (!uart[i]) {
+            error("invalid <uart_t> object", 0);
+            return -1;
+        }
+        
+        fds[i].fd = uart[i]->fd;
+        fds[i].events = 0;
+        fds[i].revents = 0;
+        
+        /* a reader thread owns the input side, a full ring stops reading */
+        if (!uart[i]->reader ||
+            (!uart[i]->reader->threaded && !reader_full(uart[i])))
+            fds[i].events |= POLLIN;
+        
+        if (uart[i]->txq && txq_pending(uart[i]) > 0)
+            fds[i].events |= POLLOUT;
+    }
+    
+    return 0;
+}
+
+int libUART_on_readable(uart_t *uart)
+{
+    if (!uart) {
+        error("invalid <uart_t> object", 0);
+        return -1;
+    }
+    
+    if (uart->mgr) {
+        error_code(UART_ERR_STATE, "port is managed");
+        return -1;
+    }
+    
+    if (!uart->reader &&
+        reader_create(uart, READER_CHUNK_SIZE, READER_CHUNKS) == -1)
+        return -1;
+    
+    if (uart->reader->threaded) {
+        error_code(UART_ERR_STATE, "reader thread running");
+        return -1;
+    }
+    
+    return reader_fill(uart);
+}
+
+int libUART_on_writable(uart_t *uart)
+{
+    if (!uart) {
+        error("invalid <uart_t> object", 0);
+        return -1;
+    }
+    
+    if (!uart->txq)
+        return 0;
+    
+    return txq_drain(uart);
+}
+
+uart_bridge_t *libUART_bridge_create(uart_t *uart, const char *addr, int flags)
+{
+    if (!uart) {
+        error("invalid <uart_t> object", 0);
+        return NULL;
+    }
+    
+    if (!addr || !addr[0]) {
+        error("invalid socket address", 0);
+        return NULL;
+    }
+    
+    if (flags & ~UART_BRIDGE_RFC2217) {
+        error("invalid bridge flags", 0);
+        return NULL;
+    }
+    
+    /* the bridge must be the only reader of the port */
+    if (uart->bridge || uart->share || uart->reader || uart->mgr) {
+        error_code(UART_ERR_STATE, "port is already read by another component");
+        return NULL;
+    }
+    
+    /* the bridge moves the data through the descriptor */
+    if (!(uart->be->flags & BACKEND_FD_DATA)) {
+        error_code(UART_ERR_STATE, "UART backend cannot be bridged");
+        return NULL;
+    }
+    
+    return bridge_create(uart, addr, flags);
+}
+
+void libUART_bridge_destroy(uart_bridge_t *bridge)
+{
+    if (!bridge) {
+        error("invalid <uart_bridge_t> object", 0);
+        return;
+    }
+    
+    bridge_destroy(bridge);
+}
+
+uart_share_t *libUART_share_create(uart_t *uart, int num, int mode)
+{
+    if (!uart) {
+        error("invalid <uart_t> object", 0);
+        return NULL;
+    }
+    
+    if (num < 1 || num > SHARE_MAX_PTYS) {
+        error("invalid number of pseudo terminals", 0);
+        return NULL;
+    }
+    
+    if (mode != UART_SHARE_FRAME && mode != UART_SHARE_LINE) {
+        error("invalid share mode", 0);
+        return NULL;
+    }
+    
+    /* the share must be the only reader of the port */
+    if (uart->bridge || uart->share || uart->reader || uart->mgr) {
+        error_code(UART_ERR_STATE, "port is already read by another component");
+        return NULL;
+    }
+    
+    return share_create(uart, num, mode);
+}
+
+void libUART_share_destroy(uart_share_t *share)
+{
+    if (!share) {
+        error("invalid <uart_share_t> object", 0);
+        return;
+    }
+    
+    share_destroy(share);
+}
+
+const char *libUART_share_get_name(uart_share_t *share, int idx)
+{
+    if (!share) {
+        error("invalid <uart_share_t> object", 0);
+        return NULL;
+    }
+    
+    if (idx < 0 || idx >= share->num) {
+        error("invalid pseudo terminal index", 0);
+        return NULL;
+    }
+    
+    return share->pty[idx].name;
+}
+
+int libUART_broadcast(uart_t **uart, int num, const char *send_buf, int len,
+                      uart_release_cb release, void *arg, int *status)
+{
+    int i;
+    
+    if (!uart || num < 1) {
+        error("invalid <uart_t> array", 0);
+        return -1;
+    }
+    
+    if (!send_buf) {
+        error("invalid send buffer", 0);
+        return -1;
+    }
+    
+    if (len < 1) {
+        error("invalid send buffer length", 0);
+        return -1;
+    }
+    
+    /* check all ports first, the payload is queued to all or none */
+    for (i = 0; i < num; i++) {
+        if (!uart[i]) {
+            error("invalid <uart_t> object", 0);
+            return -1;
+        }
+        
+        if (!uart[i]->txq) {
+            error_code(UART_ERR_STATE, "transmit queue not enabled");
+            return -1;
+        }
+    }
+    
+    return txq_broadcast(uart, num, send_buf, len, release, arg, status);
+}
+
+int libUART_get_stats(uart_t *uart, struct uart_stats *stats)
+{
+    if (!uart) {
+        error("invalid <uart_t> object", 0);
+        return -1;
+    }
+    
+    if (!stats) {
+        error("invalid <struct uart_stats> pointer", 0);
+        return -1;
+    }
+    
+    stats_get(uart, stats);
+    return 0;
+}
+
+int libUART_reset_stats(uart_t *uart)
+{
+    if (!uart) {
+        error("invalid <uart_t> object", 0);
+        return -1;
+    }
+    
+    stats_reset(uart);
+    return 0;
+}
+
+int libUART_set_latency(uart_t *uart, int enable)
+{
+    if (!uart) {
+        error("invalid <uart_t> object", 0);
+        return -1;
+    }
+    
+    if (enable) {
+        if (uart->lat)
+            return 0;
+        
+        return lat_create(uart);
+    }
+    
+    lat_destroy(uart);
+    return 0;
+}
+
+int libUART_lat_begin(uart_t *uart, int cls)
+{
+    if (!uart) {
+        error("invalid <uart_t> object", 0);
+        return -1;
+    }
+    
+    if (cls < 0 || cls >= UART_LAT_CLASSES) {
+        error("invalid command class", 0);
+        return -1;
+    }
+    
+    if (!uart->lat) {
+        error_code(UART_ERR_STATE, "latency tracking not enabled");
+        return -1;
+    }
+    
+    lat_begin(uart, cls);
+    return 0;
+}
+
+int libUART_lat_end(uart_t *uart)
+{
+    if (!uart) {
+        error("invalid <uart_t> object", 0);
+        return -1;
+    }
+    
+    if (!uart->lat) {
+        error_code(UART_ERR_STATE, "latency tracking not enabled");
+        return -1;
+    }
+    
+    return lat_end(uart);
+}
+
+int libUART_get_latency(uart_t *uart, int cls, int kind, struct uart_hist *hist)
+{
+    if (!uart) {
+        error("invalid <uart_t> object", 0);
+        return -1;
+    }
+    
+    if (cls < 0 || cls >= UART_LAT_CLASSES) {
+        error("invalid command class", 0);
+        return -1;
+    }
+    
+    if (kind < 0 || kind >= UART_LAT_KINDS) {
+        error("invalid latency kind", 0);
+        return -1;
+    }
+    
+    if (!hist) {
+        error("invalid <struct uart_hist> pointer", 0);
+        return -1;
+    }
+    
+    if (!uart->lat) {
+        error_code(UART_ERR_STATE, "latency tracking not enabled");
+        return -1;
+    }
+    
+    memcpy(hist, &uart->lat->hist[cls][kind], sizeof(*hist));
+    return 0;
+}
+
+int libUART_reset_latency(uart_t *uart)
+{
+    if (!uart) {
+        error("invalid <uart_t> object", 0);
+        return -1;
+    }
+    
+    if (!uart->lat) {
+        error_code(UART_ERR_STATE, "latency tracking not enabled");
+        return -1;
+    }
+    
+    lat_reset(uart);
+    return 0;
+}
+
+int libUART_hist_merge(struct uart_hist *dst, const struct uart_hist *src)
+{
+    if (!dst || !src) {
+        error("invalid <struct uart_hist> pointer", 0);
+        return -1;
+    }
+    
+    hist_merge(dst, src);
+    return 0;
+}
+
+long long libUART_hist_percentile(const struct uart_hist *hist, double p)
+{
+    if (!hist) {
+        error("invalid <struct uart_hist> pointer", 0);
+        return -1;
+    }
+    
+    if (p < 0.0 || p > 100.0) {
+        error("invalid percentile", 0);
+        return -1;
+    }
+    
+    return hist_percentile(hist, p);
+}
+
+int libUART_get_icount(uart_t *uart, struct uart_icount *total, struct uart_icount *delta)
+{
+    if (!uart) {
+        error("invalid <uart_t> object", 0);
+        return -1;
+    }
+    
+    return icount_get(uart, total, delta);
+}
+
+int libUART_set_icount_threshold(uart_t *uart, const struct uart_icount *threshold, uart_icount_cb cb, void *arg)
+{
+    if (!uart) {
+        error("invalid <uart_t> object", 0);
+        return -1;
+    }
+    
+    if (cb && !threshold) {
+        error("invalid <struct uart_icount> pointer", 0);
+        return -1;
+    }
+    
+    icount_set_threshold(uart, threshold, cb, arg);
+    return 0;
+}
+
+uart_sim_t *libUART_sim_open(int baud, const char *opt, const struct uart_sim_cfg *cfg)
+{
+    struct _uart line;
+    
+    memset(&line, 0, sizeof(line));
+    
+    if (parse_option(&line, opt) == -1)
+        return NULL;
+    
+    if (!uart_baud_valid(baud) || baud == UART_BAUD_0) {
+        error("invalid baud rate", 0);
+        return NULL;
+    }
+    
+    line.baud = baud;
+    
+    if (cfg && (cfg->latency_us < 0 || cfg->jitter_us < 0 ||
+                cfg->bit_error_rate < 0.0 || cfg->bit_error_rate > 1.0)) {
+        error("invalid <struct uart_sim_cfg> settings", 0);
+        return NULL;
+    }
+    
+    return sim_open(&line, cfg);
+}
+
+void libUART_sim_close(uart_sim_t *sim)
+{
+    if (!sim)
+        return;
+    
+    sim_close(sim);
+}
+
+int libUART_sim_get_dev(uart_sim_t *sim, int end, char **dev)
+{
+    if (!sim) {
+        error("invalid <uart_sim_t> object", 0);
+        return -1;
+    }
+    
+    if (end < 0 || end > 1) {
+        error("invalid simulator end", 0);
+        return -1;
+    }
+    
+    if (!dev) {
+        error("invalid <char> pointer to pointer", 0);
+        return -1;
+    }
+    
+    (*dev) = sim->dev[end];
+    return 0;
+}
+
+int libUART_trace_dump(const char *path)
+{
+    if (!path) {
+        error("invalid <char> pointer", 0);
+        return -1;
+    }
+    
+    return trace_dump(path);
+}
+
+int libUART_last_error(struct uart_error *err)
+{
+    return error_last(err);
+}
+
+void libUART_set_log_callback(uart_log_cb cb, void *arg)
+{
+    error_set_log(cb, arg);
+}
+
+int libUART_capture_start(uart_t *uart, const char *path, long seg_size, int segments)
+{
+    if (!uart) {
+        error("invalid <uart_t> object", 0);
+        return -1;
+    }
+    
+    if (!path) {
+        error("invalid <char> pointer", 0);
+        return -1;
+    }
+    
+    if (strlen(path) >= DEV_NAME_LEN) {
+        error("capture path too long", 0);
+        return -1;
+    }
+    
+    if (seg_size < CAP_MIN_SEG_SIZE) {
+        error("invalid segment size", 0);
+        return -1;
+    }
+    
+    if (segments < 1) {
+        error("invalid number of segments", 0);
+        return -1;
+    }
+    
+    return cap_start(uart, path, seg_size, segments);
+}
+
+int libUART_capture_stop(uart_t *uart)
+{
+    if (!uart) {
+        error("invalid <uart_t> object", 0);
+        return -1;
+    }
+    
+    cap_stop(uart);
+    return 0;
+}
+
+uart_t *libUART_replay_open(const char *path, double speed, int compare_tx)
+{
+    struct replay *rp;
+    uart_t *p;
+    
+    if (!path) {
+        error("invalid <char> pointer", 0);
+        return NULL;
+    }
+    
+    if (strlen(path) >= DEV_NAME_LEN) {
+        error("capture path too long", 0);
+        return NULL;
+    }
+    
+    if (speed < 0.0) {
+        error("invalid replay speed", 0);
+        return NULL;
+    }
+    
+    rp = replay_create(path, speed, compare_tx);
+    
+    if (!rp)
+        return NULL;
+    
+    /* a pseudo terminal takes any line setting */
+    p = libUART_open(rp->dev, UART_BAUD_115200, "8N1N");
+    
+    if (!p) {
+        replay_destroy(rp);
+        return NULL;
+    }
+    
+    if (replay_start(p, rp) == -1) {
+        libUART_close(p);
+        replay_destroy(rp);
+        return NULL;
+    }
+    
+    return p;
+}
+
+int libUART_replay_get_stats(uart_t *uart, struct uart_replay_stats *stats)
+{
+    if (!uart) {
+        error("invalid <uart_t> object", 0);
+        return -1;
+    }
+    
+    if (!stats) {
+        error("invalid <struct uart_replay_stats> pointer", 0);
+        return -1;
+    }
+    
+    if (!uart->replay) {
+        error_code(UART_ERR_STATE, "port is not a replay");
+        return -1;
+    }
+    
+    replay_get(uart, stats);
+    return 0;
+}
+
+int libUART_open_many(const char **devs, int num, int baud, const char *opt, uart_t **uart, int *status)
+{
+    if (!devs) {
+        error("invalid device list", 0);
+        return -1;
+    }
+    
+    if (num < 1) {
+        error("invalid number of devices", 0);
+        return -1;
+    }
+    
+    if (!opt) {
+        error("invalid <char> pointer", 0);
+        return -1;
+    }
+    
+    if (!uart) {
+        error("invalid <uart_t> array", 0);
+        return -1;
+    }
+    
+    return bulk_open(devs, num, baud, opt, uart, status);
+}
+
+uart_mgr_t *libUART_mgr_create(int slab_size, int slabs, int budget)
+{
+    if (slab_size < 1) {
+        error("invalid slab size", 0);
+        return NULL;
+    }
+    
+    if (slabs < 1) {
+        error("invalid number of slabs", 0);
+        return NULL;
+    }
+    
+    if (budget < 1) {
+        error("invalid read budget", 0);
+        return NULL;
+    }
+    
+    return mgr_create(slab_size, slabs, budget);
+}
+
+void libUART_mgr_destroy(uart_mgr_t *mgr)
+{
+    if (!mgr)
+        return;
+    
+    mgr_destroy(mgr);
+}
+
+int libUART_mgr_add(uart_mgr_t *mgr, uart_t *uart)
+{
+    if (!mgr) {
+        error("invalid <uart_mgr_t> object", 0);
+        return -1;
+    }
+    
+    if (!uart) {
+        error("invalid <uart_t> object", 0);
+        return -1;
+    }
+    
+    if (uart->mgr) {
+        error_code(UART_ERR_STATE, "port is already managed");
+        return -1;
+    }
+    
+    if (uart->reader || uart->txq) {
+        error_code(UART_ERR_STATE, "receive ring or transmit queue in use");
+        return -1;
+    }
+    
+    return mgr_add(mgr, uart, NULL);
+}
+
+int libUART_mgr_remove(uart_mgr_t *mgr, uart_t *uart)
+{
+    if (!mgr) {
+        error("invalid <uart_mgr_t> object", 0);
+        return -1;
+    }
+    
+    if (!uart) {
+        error("invalid <uart_t> object", 0);
+        return -1;
+    }
+    
+    if (!uart->mgr || uart->mgr->mgr != mgr) {
+        error_code(UART_ERR_STATE, "port is not managed by <uart_mgr_t>");
+        return -1;
+    }
+    
+    uart_reopen_lock();
+    mgr_remove(uart);
+    uart_reopen_unlock();
+    return 0;
+}
+
+int libUART_mgr_poll(uart_mgr_t *mgr, uart_t **ready, int max, int timeout_ms)
+{
+    if (!mgr) {
+        error("invalid <uart_mgr_t> object", 0);
+        return -1;
+    }
+    
+    if (!ready) {
+        error("invalid <uart_t> array", 0);
+        return -1;
+    }
+    
+    if (max < 1) {
+        error("invalid array size", 0);
+        return -1;
+    }
+    
+    return mgr_poll(mgr, ready, max, timeout_ms);
+}
+
+uart_pool_t *libUART_pool_create(const struct uart_pool_cfg *cfg, uart_pool_cb cb)
+{
+    if (!cfg) {
+        error("invalid <struct uart_pool_cfg> pointer", 0);
+        return NULL;
+    }
+    
+    if (!cb) {
+        error("invalid callback", 0);
+        return NULL;
+    }
+    
+    if (cfg->workers < 1) {
+        error("invalid number of workers", 0);
+        return NULL;
+    }
+    
+    if (cfg->slab_size < 1 || cfg->slabs < 1 || cfg->budget < 1) {
+        error("invalid <struct uart_pool_cfg> buffer settings", 0);
+        return NULL;
+    }
+    
+    return pool_create(cfg, cb);
+}
+
+void libUART_pool_destroy(uart_pool_t *pool)
+{
+    if (!pool)
+        return;
+    
+    pool_destroy(pool);
+}
+
+int libUART_pool_add(uart_pool_t *pool, uart_t *uart, int shard, void *ctx)
+{
+    if (!pool) {
+        error("invalid <uart_pool_t> object", 0);
+        return -1;
+    }
+    
+    if (!uart) {
+        error("invalid <uart_t> object", 0);
+        return -1;
+    }
+    
+    if (shard < -1 || shard >= pool->shards) {
+        error("invalid shard", 0);
+        return -1;
+    }
+    
+    if (uart->mgr) {
+        error_code(UART_ERR_STATE, "port is already managed");
+        return -1;
+    }
+    
+    if (uart->reader || uart->txq) {
+        error_code(UART_ERR_STATE, "receive ring or transmit queue in use");
+        return -1;
+    }
+    
+    return pool_add(pool, uart, shard, ctx);
+}
+
+int libUART_pool_remove(uart_pool_t *pool, uart_t *uart)
+{
+    if (!pool) {
+        error("invalid <uart_pool_t> object", 0);
+        return -1;
+    }
+    
+    if (!uart) {
+        error("invalid <uart_t> object", 0);
+        return -1;
+    }
+    
+    return pool_remove(pool, uart);
+}
+
+int libUART_pool_move(uart_pool_t *pool, uart_t *uart, int shard)
+{
+    if (!pool) {
+        error("invalid <uart_pool_t> object", 0);
+        return -1;
+    }
+    
+    if (!uart) {
+        error("invalid <uart_t> object", 0);
+        return -1;
+    }
+    
+    if (shard < 0 || shard >= pool->shards) {
+        error("invalid shard", 0);
+        return -1;
+    }
+    
+    return pool_move(pool, uart, shard);
+}
+
+int libUART_pool_get_shard(uart_pool_t *pool, uart_t *uart, int *shard)
+{
+    if (!pool) {
+        error("invalid <uart_pool_t> object", 0);
+        return -1;
+    }
+    
+    if (!uart) {
+        error("invalid <uart_t> object", 0);
+        return -1;
+    }
+    
+    if (!shard) {
+        error("invalid <int> pointer", 0);
+        return -1;
+    }
+    
+    (*shard) = pool_shard_of(pool, uart);
+    
+    if ((*shard) == -1) {
+        error_code(UART_ERR_STATE, "port is not in <uart_pool_t>");
+        return -1;
+    }
+    
+    return 0;
+}
+
+int libUART_pool_get_load(uart_pool_t *pool, int shard, struct uart_shard_load *load)
+{
+    if (!pool) {
+        error("invalid <uart_pool_t> object", 0);
+        return -1;
+    }
+    
+    if (shard < 0 || shard >= pool->shards) {
+        error("invalid shard", 0);
+        return -1;
+    }
+    
+    if (!load) {
+        error("invalid <struct uart_shard_load> pointer", 0);
+        return -1;
+    }
+    
+    pool_get_load(pool, shard, load);
+    return 0;
+}
+
+int libUART_enumerate(struct uart_port_info *ports, int max)
+{
+    if (max < 0) {
+        error("invalid array size", 0);
+        return -1;
+    }
+    
+    if (!ports && max > 0) {
+        error("invalid <struct uart_port_info> array", 0);
+        return -1;
+    }
+    
+    return enum_ports(ports, max);
+}
+
+int libUART_hotplug_watch(uart_t *uart, uart_hotplug_cb cb, void *arg)
+{
+    if (!uart) {
+        error("invalid <uart_t> object", 0);
+        return -1;
+    }
+    
+    if (!(uart->be->flags & BACKEND_TTY)) {
+        error_code(UART_ERR_STATE, "port is not a serial device");
+        return -1;
+    }
+    
+    return hotplug_watch(uart, cb, arg);
+}
+
+int libUART_hotplug_unwatch(uart_t *uart)
+{
+    if (!uart) {
+        error("invalid <uart_t> object", 0);
+        return -1;
+    }
+    
+    if (!uart->hp) {
+        error_code(UART_ERR_STATE, "port is not watched");
+        return -1;
+    }
+    
+    hotplug_unwatch(uart);
+    return 0;
+}
+
+int libUART_set_reconnect(uart_t *uart, int min_ms, int max_ms)
+{
+    if (!uart) {
+        error("invalid <uart_t> object", 0);
+        return -1;
+    }
+    
+    if (min_ms == 0) {
+        if (uart->rc)
+            reconnect_disable(uart);
+        
+        return 0;
+    }
+    
+    if (min_ms < 0 || max_ms < min_ms) {
+        error("invalid retry delay", 0);
+        return -1;
+    }
+    
+    if (!(uart->be->flags & BACKEND_REOPEN)) {
+        error_code(UART_ERR_STATE, "UART backend cannot be reopened");
+        return -1;
+    }
+    
+    return reconnect_enable(uart, min_ms, max_ms);
+}
+
+int libUART_get_reconnecting(uart_t *uart, int *state)
+{
+    if (!uart) {
+        error("invalid <uart_t> object", 0);
+        return -1;
+    }
+    
+    if (!state) {
+        error("invalid <int> pointer", 0);
+        return -1;
+    }
+    
+    (*state) = reconnect_pending(uart);
+    return 0;
+}
+#endif
+
 void libUART_set_error(int enable)
 {
     error_enable(enable);
@@ -0,0 +1,179 @@
+/**
+ *
+ * File Name: tools/trace_dump.c
+ * Title    : libUART trace timeline renderer
+ * Project  : libUART
+ * Author   : Copyright (C) 2018-2020 Johannes Krottmayer <krjdev@gmail.com>
+ * Created  : 2026-10-19
+ * Modified :
+ * Revised  :
+ * Version  : 0.1.0.0
+ * License  : ISC (see file LICENSE.txt)
+ *
+ * NOTE: This code is currently below version 1.0, and therefore is considered
+ * to be lacking in some functionality or documentation, or may not be fully
+ * tested. Nonetheless, you can expect most functions to work.
+ *
+ */
+
+/*
+ * Reads a file written by libUART_trace_dump() and prints the events of
+ * all threads as one timeline, relative to the first event. Exit events
+ * show the time spent in the call.
+ *
+ * Usage: libUART_trace <trace file>
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "../unix/trace.h"
+
+/* depth of nested calls matched per thread */
+#define STACK_SIZE          16
+
+struct event {
+    struct trace_rec rec;
+    uint32_t tid;
+    size_t seq;
+    int64_t dur_ns;
+};
+
+static const char *event_name[TRACE_EVENTS] = {
+    "uart_send",
+    "uart_sendv",
+    "uart_recv",
+    "uart_init_baud",
+    "uart_init_databits",
+    "uart_init_parity",
+    "uart_init_stopbits",
+    "uart_init_flow",
+    "uart_set_pin",
+    "uart_get_pin",
+    "uart_get_bytes"
+};
+
+static int event_cmp(const void *a, const void *b)
+{
+    const struct event *x = (const struct event *) a;
+    const struct event *y = (const struct event *) b;
+
+    if (x->rec.ts_ns != y->rec.ts_ns)
+        return x->rec.ts_ns < y->rec.ts_ns ? -1 : 1;
+
+    /* keep the order of a thread for equal time stamps */
+    return x->seq < y->seq ? -1 : (x->seq > y->seq);
+}
+
+/* pair the exits of one thread with their entries */
+static void match_thread(struct event *ev, uint32_t count)
+{
+    struct event *stack[STACK_SIZE];
+    int depth = 0;
+    uint32_t i;
+
+    for (i = 0; i < count; i++) {
+        ev[i].dur_ns = -1;
+
+        if (ev[i].rec.phase == TRACE_PHASE_ENTER) {
+            if (depth < STACK_SIZE)
+                stack[depth++] = &ev[i];
+
+            continue;
+        }
+
+        /* the entry may have been overwritten when the ring wrapped */
+        if (depth > 0 && stack[depth - 1]->rec.event == ev[i].rec.event &&
+            stack[depth - 1]->rec.port == ev[i].rec.port) {
+            depth--;
+            ev[i].dur_ns = ev[i].rec.ts_ns - stack[depth]->rec.ts_ns;
+        }
+    }
+}
+
+int main(int argc, char **argv)
+{
+    struct trace_file_hdr hdr;
+    struct trace_thread_hdr thr;
+    struct event *ev = NULL;
+    struct event *tmp;
+    size_t total = 0;
+    size_t i;
+    uint32_t t;
+    uint32_t j;
+    FILE *f;
+
+    if (argc != 2) {
+        fprintf(stderr, "usage: %s <trace file>\n", argv[0]);
+        return 1;
+    }
+
+    f = fopen(argv[1], "rb");
+
+    if (!f) {
+        perror(argv[1]);
+        return 1;
+    }
+
+    if (fread(&hdr, sizeof(hdr), 1, f) != 1 || hdr.magic != TRACE_MAGIC ||
+        hdr.version != TRACE_VERSION ||
+        hdr.rec_size != sizeof(struct trace_rec)) {
+        fprintf(stderr, "%s: not a libUART trace file\n", argv[1]);
+        fclose(f);
+        return 1;
+    }
+
+    for (t = 0; t < hdr.threads; t++) {
+        if (fread(&thr, sizeof(thr), 1, f) != 1)
+            break;
+
+        tmp = (struct event *) realloc(ev, (total + thr.count) * sizeof(*ev));
+
+        if (!tmp) {
+            fprintf(stderr, "out of memory\n");
+            free(ev);
+            fclose(f);
+            return 1;
+        }
+
+        ev = tmp;
+
+        for (j = 0; j < thr.count; j++) {
+            if (fread(&ev[total + j].rec, sizeof(struct trace_rec), 1,
+                      f) != 1)
+                break;
+
+            ev[total + j].tid = thr.tid;
+            ev[total + j].seq = total + j;
+        }
+
+        match_thread(&ev[total], j);
+        total += j;
+
+        if (j != thr.count)
+            break;
+    }
+
+    fclose(f);
+    qsort(ev, total, sizeof(*ev), event_cmp);
+    printf("%14s %5s %5s  %-20s %-5s %8s %8s %10s\n", "time_us", "tid",
+           "port", "event", "phase", "size", "result", "dur_us");
+
+    for (i = 0; i < total; i++) {
+        printf("%14.3f %5u %5u  %-20s %-5s %8d %8d",
+               (ev[i].rec.ts_ns - ev[0].rec.ts_ns) / 1000.0, ev[i].tid,
+               ev[i].rec.port,
+               ev[i].rec.event < TRACE_EVENTS ?
+               event_name[ev[i].rec.event] : "?",
+               ev[i].rec.phase == TRACE_PHASE_ENTER ? "enter" : "exit",
+               ev[i].rec.size, ev[i].rec.result);
+
+        if (ev[i].dur_ns >= 0)
+            printf(" %10.3f", ev[i].dur_ns / 1000.0);
+
+        printf("\n");
+    }
+
+    free(ev);
+    return 0;
+}
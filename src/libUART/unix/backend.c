@@ -0,0 +1,403 @@
+/**
+ *
+ * File Name: unix/backend.c
+ * Title    : UNIX UART transport backends
+ * Project  : libUART
+ * Author   : Copyright (C) 2018-2020 Johannes Krottmayer <krjdev@gmail.com>
+ * Created  : 2026-10-19
+ * Modified :
+ * Revised  :
+ * Version  : 0.1.0.0
+ * License  : ISC (see file LICENSE.txt)
+ *
+ * NOTE: This code is currently below version 1.0, and therefore is considered
+ * to be lacking in some functionality or documentation, or may not be fully
+ * tested. Nonetheless, you can expect most functions to work.
+ *
+ */
+
+/* ptsname_r() */
+#define _GNU_SOURCE
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <termios.h>
+#include <netdb.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+
+#include "error.h"
+#include "backend.h"
+
+/* modem inputs of a port without modem lines */
+#define EMUL_INPUTS         (TIOCM_CTS | TIOCM_DSR | TIOCM_CAR)
+#define EMUL_OUTPUTS        (TIOCM_RTS | TIOCM_DTR)
+
+struct backend_pty {
+    int slave;                  /* kept open, the master never hangs up */
+    char name[64];
+    char link[DEV_NAME_LEN];    /* symlink to remove, empty if none */
+};
+
+static void fd_close(struct _uart *uart)
+{
+    close(uart->fd);
+}
+
+static ssize_t fd_read(struct _uart *uart, void *buf, size_t len)
+{
+    return read(uart->fd, buf, len);
+}
+
+static ssize_t fd_writev(struct _uart *uart, const struct iovec *iov, int cnt)
+{
+    return writev(uart->fd, iov, cnt);
+}
+
+static int fd_bytes_available(struct _uart *uart, int *bytes)
+{
+    return ioctl(uart->fd, FIONREAD, bytes);
+}
+
+static int flush_none(struct _uart *uart)
+{
+    (void) uart;
+    return 0;
+}
+
+/* settings are kept in the port only, there is no line to set up */
+int backend_conf_keep(struct _uart *uart)
+{
+    (void) uart;
+    return 0;
+}
+
+static int emul_get_pins(struct _uart *uart, int *status)
+{
+    (*status) = atomic_load(&uart->modem);
+    return 0;
+}
+
+static int emul_set_pins(struct _uart *uart, int status)
+{
+    int old = atomic_load(&uart->modem);
+
+    while (!atomic_compare_exchange_weak(&uart->modem, &old,
+                                         (old & ~EMUL_OUTPUTS) |
+                                         (status & EMUL_OUTPUTS)));
+
+    return 0;
+}
+
+static int tty_open(struct _uart *uart, const char *name)
+{
+    int fd;
+
+    (void) uart;
+    fd = open(name, O_RDWR | O_NOCTTY | O_NDELAY);
+
+    if (fd == -1) {
+        error("open() failed", 1);
+        return -1;
+    }
+
+    return fd;
+}
+
+static int tty_get_pins(struct _uart *uart, int *status)
+{
+    return ioctl(uart->fd, TIOCMGET, status);
+}
+
+static int tty_set_pins(struct _uart *uart, int status)
+{
+    return ioctl(uart->fd, TIOCMSET, &status);
+}
+
+static int tty_flush(struct _uart *uart)
+{
+    return fsync(uart->fd);
+}
+
+static const struct uart_backend backend_tty = {
+    .prefix = "",
+    .flags = BACKEND_TTY | BACKEND_REOPEN | BACKEND_FD_DATA,
+    .open = tty_open,
+    .close = fd_close,
+    .read = fd_read,
+    .writev = fd_writev,
+    .configure = NULL,
+    .get_pins = tty_get_pins,
+    .set_pins = tty_set_pins,
+    .bytes_available = fd_bytes_available,
+    .flush = tty_flush
+};
+
+static void pty_free(struct backend_pty *p)
+{
+    if (p->slave != -1)
+        close(p->slave);
+
+    if (p->link[0])
+        unlink(p->link);
+
+    free(p);
+}
+
+/*
+ * The port is the master of a new pseudo terminal, other programs open
+ * the slave, or the symlink to it given after the prefix.
+ */
+static int pty_open(struct _uart *uart, const char *name)
+{
+    struct backend_pty *p;
+    struct termios options;
+    int fd;
+
+    if (strlen(name) >= sizeof(p->link)) {
+        error_code(UART_ERR_INVAL, "pty link name too long");
+        return -1;
+    }
+
+    p = (struct backend_pty *) calloc(1, sizeof(*p));
+
+    if (!p) {
+        error("calloc() failed", 1);
+        return -1;
+    }
+
+    p->slave = -1;
+    fd = posix_openpt(O_RDWR | O_NOCTTY | O_NONBLOCK | O_CLOEXEC);
+
+    if (fd == -1) {
+        error("posix_openpt() failed", 1);
+        pty_free(p);
+        return -1;
+    }
+
+    if (grantpt(fd) == -1 || unlockpt(fd) == -1 ||
+        ptsname_r(fd, p->name, sizeof(p->name)) != 0) {
+        error("unlockpt() failed", 1);
+        goto err;
+    }
+
+    p->slave = open(p->name, O_RDWR | O_NOCTTY | O_NONBLOCK | O_CLOEXEC);
+
+    if (p->slave == -1) {
+        error("open() failed", 1);
+        goto err;
+    }
+
+    /* pass the data through unchanged until a client sets up the pty */
+    if (tcgetattr(p->slave, &options) == 0) {
+        cfmakeraw(&options);
+        tcsetattr(p->slave, TCSANOW, &options);
+    }
+
+    if (name[0]) {
+        if (symlink(p->name, name) == -1) {
+            error("symlink() failed", 1);
+            goto err;
+        }
+
+        strcpy(p->link, name);
+    }
+
+    atomic_store(&uart->modem, EMUL_INPUTS);
+    uart->be_priv = p;
+    return fd;
+
+err:
+    close(fd);
+    pty_free(p);
+    return -1;
+}
+
+static void pty_close(struct _uart *uart)
+{
+    close(uart->fd);
+    pty_free((struct backend_pty *) uart->be_priv);
+    uart->be_priv = NULL;
+}
+
+static const struct uart_backend backend_pty = {
+    .prefix = "pty:",
+    .flags = BACKEND_FD_DATA,
+    .open = pty_open,
+    .close = pty_close,
+    .read = fd_read,
+    .writev = fd_writev,
+    .configure = backend_conf_keep,
+    .get_pins = emul_get_pins,
+    .set_pins = emul_set_pins,
+    .bytes_available = fd_bytes_available,
+    .flush = flush_none
+};
+
+/* "host:port" or "[host]:port", e.g. a port of a terminal server */
+static int tcp_open(struct _uart *uart, const char *name)
+{
+    struct addrinfo hints;
+    struct addrinfo *res;
+    struct addrinfo *ai;
+    char host[DEV_NAME_LEN];
+    const char *port;
+    size_t len;
+    int one = 1;
+    int fd = -1;
+    int ret;
+
+    port = strrchr(name, ':');
+
+    if (!port || !port[1]) {
+        error_code(UART_ERR_INVAL, "invalid TCP address");
+        return -1;
+    }
+
+    len = port - name;
+
+    if (name[0] == '[' && len >= 2 && name[len - 1] == ']') {
+        name++;
+        len -= 2;
+    }
+
+    memcpy(host, name, len);
+    host[len] = '\0';
+    port++;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    ret = getaddrinfo(host, port, &hints, &res);
+
+    if (ret != 0) {
+        error_code(UART_ERR_INVAL, gai_strerror(ret));
+        return -1;
+    }
+
+    for (ai = res; ai; ai = ai->ai_next) {
+        fd = socket(ai->ai_family, ai->ai_socktype | SOCK_CLOEXEC,
+                    ai->ai_protocol);
+
+        if (fd == -1)
+            continue;
+
+        if (connect(fd, ai->ai_addr, ai->ai_addrlen) == 0)
+            break;
+
+        close(fd);
+        fd = -1;
+    }
+
+    freeaddrinfo(res);
+
+    if (fd == -1) {
+        error("connect() failed", 1);
+        return -1;
+    }
+
+    /* a serial line does not wait to fill segments */
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    atomic_fetch_or(&uart->modem, EMUL_INPUTS);
+    return fd;
+}
+
+/*
+ * A closed connection behaves like a lost device: reads and writes fail
+ * with EIO and the socket polls with POLLHUP set, so the reader, the
+ * manager and the reconnect logic handle both the same way.
+ */
+static void tcp_hangup(struct _uart *uart)
+{
+    shutdown(uart->fd, SHUT_RDWR);
+    atomic_fetch_and(&uart->modem, ~EMUL_INPUTS);
+}
+
+static ssize_t tcp_read(struct _uart *uart, void *buf, size_t len)
+{
+    ssize_t ret;
+
+    ret = read(uart->fd, buf, len);
+
+    if (ret == 0 || (ret == -1 && errno == ECONNRESET)) {
+        tcp_hangup(uart);
+        errno = EIO;
+        return -1;
+    }
+
+    return ret;
+}
+
+static ssize_t tcp_writev(struct _uart *uart, const struct iovec *iov, int cnt)
+{
+    struct msghdr msg;
+    ssize_t ret;
+
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = (struct iovec *) iov;
+    msg.msg_iovlen = cnt;
+    ret = sendmsg(uart->fd, &msg, MSG_NOSIGNAL);
+
+    if (ret == -1 && (errno == EPIPE || errno == ECONNRESET)) {
+        tcp_hangup(uart);
+        errno = EIO;
+    }
+
+    return ret;
+}
+
+static const struct uart_backend backend_tcp = {
+    .prefix = "tcp:",
+    .flags = BACKEND_REOPEN | BACKEND_FD_DATA,
+    .open = tcp_open,
+    .close = fd_close,
+    .read = tcp_read,
+    .writev = tcp_writev,
+    .configure = backend_conf_keep,
+    .get_pins = emul_get_pins,
+    .set_pins = emul_set_pins,
+    .bytes_available = fd_bytes_available,
+    .flush = flush_none
+};
+
+/* the slave device of a "pty:" port, NULL for other backends */
+const char *backend_pty_name(struct _uart *uart)
+{
+    if (uart->be != &backend_pty)
+        return NULL;
+
+    return ((struct backend_pty *) uart->be_priv)->name;
+}
+
+/* the tty backend takes every name without a known prefix */
+static const struct uart_backend *g_backends[] = {
+    &backend_pty,
+    &backend_tcp,
+    &backend_mem,
+    &backend_tty
+};
+
+const struct uart_backend *backend_find(const char *dev)
+{
+    const struct uart_backend *be;
+    size_t i;
+
+    for (i = 0; i < sizeof(g_backends) / sizeof(g_backends[0]); i++) {
+        be = g_backends[i];
+
+        if (strncmp(dev, be->prefix, strlen(be->prefix)) == 0)
+            return be;
+    }
+
+    return &backend_tty;
+}
+
+/* the device name without the prefix of the backend */
+const char *backend_name(struct _uart *uart)
+{
+    return uart->dev + strlen(uart->be->prefix);
+}
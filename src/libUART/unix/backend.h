@@ -0,0 +1,69 @@
+/**
+ *
+ * File Name: unix/backend.h
+ * Title    : UNIX UART transport backends
+ * Project  : libUART
+ * Author   : Copyright (C) 2018-2020 Johannes Krottmayer <krjdev@gmail.com>
+ * Created  : 2026-10-19
+ * Modified :
+ * Revised  :
+ * Version  : 0.1.0.0
+ * License  : ISC (see file LICENSE.txt)
+ *
+ * NOTE: This code is currently below version 1.0, and therefore is considered
+ * to be lacking in some functionality or documentation, or may not be fully
+ * tested. Nonetheless, you can expect most functions to work.
+ *
+ */
+
+#ifndef LIBUART_UNIX_BACKEND_H
+#define LIBUART_UNIX_BACKEND_H
+
+#include <sys/types.h>
+#include <sys/uio.h>
+
+#include "uart.h"
+
+/* a serial device, termios settings, modem ioctls and hotplug apply */
+#define BACKEND_TTY         0x01
+/* the device can be opened again after it went away */
+#define BACKEND_REOPEN      0x02
+/* the data passes through the descriptor, e.g. for splice() */
+#define BACKEND_FD_DATA     0x04
+
+/* bytes buffered per direction of an in-memory pipe, a power of two */
+#define MEM_RING_SIZE       65536
+
+/*
+ * Transport below a port, chosen by the prefix of the device name. The
+ * descriptor returned by open() is uart->fd and polls readable when data
+ * is waiting, so the reader, manager and pool work with every backend.
+ * Except for open(), the calls behave like system calls: they return -1
+ * and set errno without reporting an error, read() and writev() fail with
+ * EAGAIN if they would block.
+ */
+struct uart_backend {
+    const char *prefix;
+    int flags;                  /* BACKEND_* */
+    /* returns the descriptor of the port or -1 */
+    int (*open)(struct _uart *uart, const char *name);
+    void (*close)(struct _uart *uart);
+    ssize_t (*read)(struct _uart *uart, void *buf, size_t len);
+    ssize_t (*writev)(struct _uart *uart, const struct iovec *iov, int cnt);
+    /* applies the line settings of the port, NULL for termios */
+    int (*configure)(struct _uart *uart);
+    /* TIOCM_* bits */
+    int (*get_pins)(struct _uart *uart, int *status);
+    int (*set_pins)(struct _uart *uart, int status);
+    int (*bytes_available)(struct _uart *uart, int *bytes);
+    int (*flush)(struct _uart *uart);
+};
+
+extern const struct uart_backend backend_mem;
+
+extern const struct uart_backend *backend_find(const char *dev);
+extern const char *backend_name(struct _uart *uart);
+extern int backend_conf_keep(struct _uart *uart);
+extern const char *backend_pty_name(struct _uart *uart);
+
+#endif
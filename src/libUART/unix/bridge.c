@@ -0,0 +1,998 @@
+/**
+ *
+ * File Name: unix/bridge.c
+ * Title    : UNIX UART serial to socket bridge
+ * Project  : libUART
+ * Author   : Copyright (C) 2018-2020 Johannes Krottmayer <krjdev@gmail.com>
+ * Created  : 2026-10-19
+ * Modified :
+ * Revised  :
+ * Version  : 0.1.0.0
+ * License  : ISC (see file LICENSE.txt)
+ *
+ * NOTE: This code is currently below version 1.0, and therefore is considered
+ * to be lacking in some functionality or documentation, or may not be fully
+ * tested. Nonetheless, you can expect most functions to work.
+ *
+ */
+
+/* splice(), pipe2(), accept4() */
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <poll.h>
+#include <signal.h>
+#include <unistd.h>
+#include <termios.h>
+#include <netdb.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/eventfd.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+
+#include "../version.h"
+#include "error.h"
+#include "stats.h"
+#include "latency.h"
+#include "capture.h"
+#include "reconnect.h"
+#include "backend.h"
+#include "bridge.h"
+
+/* telnet commands and options (RFC 854, 856, 858, 2217) */
+#define TELNET_SE           240
+#define TELNET_SB           250
+#define TELNET_WILL         251
+#define TELNET_WONT         252
+#define TELNET_DO           253
+#define TELNET_DONT         254
+#define TELNET_IAC          255
+#define TELNET_BINARY       0
+#define TELNET_SGA          3
+#define TELNET_COM_PORT     44
+
+/* TELNET_OPT_* flags of struct bridge_telnet */
+#define TELNET_OPT_US       0x01    /* enabled on our side */
+#define TELNET_OPT_HIM      0x02    /* enabled on the client side */
+#define TELNET_OPT_WILL     0x04    /* we sent WILL, the DO is an answer */
+#define TELNET_OPT_DO       0x08    /* we sent DO, the WILL is an answer */
+
+enum e_telnet_state {
+    TELNET_DATA,
+    TELNET_CMD,
+    TELNET_OPT,
+    TELNET_SUB,
+    TELNET_SUB_IAC
+};
+
+/* RFC 2217 client to server commands, the server answers with +100 */
+enum e_com_port {
+    COM_SIGNATURE,
+    COM_SET_BAUDRATE,
+    COM_SET_DATASIZE,
+    COM_SET_PARITY,
+    COM_SET_STOPSIZE,
+    COM_SET_CONTROL,
+    COM_NOTIFY_LINESTATE,
+    COM_NOTIFY_MODEMSTATE,
+    COM_FLOW_SUSPEND,
+    COM_FLOW_RESUME,
+    COM_SET_LINESTATE_MASK,
+    COM_SET_MODEMSTATE_MASK,
+    COM_PURGE_DATA
+};
+
+#define COM_SERVER          100
+
+/* append data for the client, e.g. a telnet reply */
+static void bridge_append(struct bridge_dir *d, const void *data, int len)
+{
+    if (d->off > 0) {
+        memmove(d->buf, d->buf + d->off, d->len);
+        d->off = 0;
+    }
+
+    /* only a misbehaving client fills the buffer with requests */
+    if (d->len + len > BRIDGE_OUT_SIZE)
+        return;
+
+    memcpy(d->buf + d->len, data, len);
+    d->len += len;
+}
+
+static void telnet_send(struct _uart_bridge *br, int cmd, int opt)
+{
+    unsigned char msg[3];
+
+    msg[0] = TELNET_IAC;
+    msg[1] = cmd;
+    msg[2] = opt;
+    bridge_append(&br->up, msg, 3);
+}
+
+/* answer a COM port command, IAC bytes of the value are doubled */
+static void telnet_reply(struct _uart_bridge *br, int cmd,
+                         const unsigned char *val, int len)
+{
+    unsigned char msg[4 + 2 * BRIDGE_SB_SIZE + 2];
+    int n = 0;
+    int i;
+
+    msg[n++] = TELNET_IAC;
+    msg[n++] = TELNET_SB;
+    msg[n++] = TELNET_COM_PORT;
+    msg[n++] = cmd + COM_SERVER;
+
+    for (i = 0; i < len && i < BRIDGE_SB_SIZE; i++) {
+        if (val[i] == TELNET_IAC)
+            msg[n++] = TELNET_IAC;
+
+        msg[n++] = val[i];
+    }
+
+    msg[n++] = TELNET_IAC;
+    msg[n++] = TELNET_SE;
+    bridge_append(&br->up, msg, n);
+}
+
+static void telnet_reply_byte(struct _uart_bridge *br, int cmd, int val)
+{
+    unsigned char c = val;
+
+    telnet_reply(br, cmd, &c, 1);
+}
+
+static void telnet_start(struct _uart_bridge *br)
+{
+    struct bridge_telnet *tn = &br->tn;
+
+    memset(tn, 0, sizeof(*tn));
+    tn->state = TELNET_DATA;
+    tn->opt[TELNET_BINARY] = TELNET_OPT_WILL | TELNET_OPT_DO;
+    tn->opt[TELNET_SGA] = TELNET_OPT_WILL;
+    tn->opt[TELNET_COM_PORT] = TELNET_OPT_DO;
+    telnet_send(br, TELNET_WILL, TELNET_BINARY);
+    telnet_send(br, TELNET_DO, TELNET_BINARY);
+    telnet_send(br, TELNET_WILL, TELNET_SGA);
+    telnet_send(br, TELNET_DO, TELNET_COM_PORT);
+}
+
+/* option negotiation, answers only requests to avoid loops */
+static void telnet_option(struct _uart_bridge *br, int cmd, int opt)
+{
+    unsigned char *f = &br->tn.opt[opt];
+    int ours = opt == TELNET_BINARY || opt == TELNET_SGA;
+    int his = ours || opt == TELNET_COM_PORT;
+
+    switch (cmd) {
+    case TELNET_DO:
+        if (!ours) {
+            telnet_send(br, TELNET_WONT, opt);
+        } else if (!((*f) & TELNET_OPT_US)) {
+            if (!((*f) & TELNET_OPT_WILL))
+                telnet_send(br, TELNET_WILL, opt);
+
+            (*f) |= TELNET_OPT_US;
+        }
+
+        break;
+    case TELNET_DONT:
+        if ((*f) & TELNET_OPT_US) {
+            (*f) &= ~(TELNET_OPT_US | TELNET_OPT_WILL);
+            telnet_send(br, TELNET_WONT, opt);
+        }
+
+        break;
+    case TELNET_WILL:
+        if (!his) {
+            telnet_send(br, TELNET_DONT, opt);
+        } else if (!((*f) & TELNET_OPT_HIM)) {
+            if (!((*f) & TELNET_OPT_DO))
+                telnet_send(br, TELNET_DO, opt);
+
+            (*f) |= TELNET_OPT_HIM;
+        }
+
+        break;
+    case TELNET_WONT:
+        if ((*f) & TELNET_OPT_HIM) {
+            (*f) &= ~(TELNET_OPT_HIM | TELNET_OPT_DO);
+            telnet_send(br, TELNET_DONT, opt);
+        }
+
+        break;
+    }
+}
+
+static int com_parity(int parity)
+{
+    switch (parity) {
+    case UART_PARITY_ODD:
+        return 2;
+    case UART_PARITY_EVEN:
+        return 3;
+    default:
+        return 1;
+    }
+}
+
+static int com_flow(int flow_ctrl)
+{
+    switch (flow_ctrl) {
+    case UART_FLOW_SOFTWARE:
+        return 2;
+    case UART_FLOW_HARDWARE:
+        return 3;
+    default:
+        return 1;
+    }
+}
+
+static int com_pin(struct _uart *uart, int pin, int on, int off)
+{
+    int state = UART_PIN_LOW;
+
+    uart_get_pin(uart, pin, &state);
+    return state == UART_PIN_HIGH ? on : off;
+}
+
+static void com_control(struct _uart_bridge *br, int val)
+{
+    struct _uart *uart = br->uart;
+
+    switch (val) {
+    case 1:
+    case 2:
+    case 3:
+        uart->flow_ctrl = val == 1 ? UART_FLOW_NO :
+                          val == 2 ? UART_FLOW_SOFTWARE : UART_FLOW_HARDWARE;
+        uart_init_flow(uart);
+        /* fall through */
+    case 0:
+        val = com_flow(uart->flow_ctrl);
+        break;
+    case 5:
+        ioctl(uart->fd, TIOCSBRK);
+        break;
+    case 6:
+        ioctl(uart->fd, TIOCCBRK);
+        break;
+    case 7:
+        val = com_pin(uart, UART_PIN_DTR, 8, 9);
+        break;
+    case 8:
+    case 9:
+        uart_set_pin(uart, UART_PIN_DTR, val == 8 ? UART_PIN_HIGH :
+                     UART_PIN_LOW);
+        break;
+    case 10:
+        val = com_pin(uart, UART_PIN_RTS, 11, 12);
+        break;
+    case 11:
+    case 12:
+        uart_set_pin(uart, UART_PIN_RTS, val == 11 ? UART_PIN_HIGH :
+                     UART_PIN_LOW);
+        break;
+    default:
+        /* break state and inbound flow control are not tracked */
+        break;
+    }
+
+    telnet_reply_byte(br, COM_SET_CONTROL, val);
+}
+
+/* RFC 2217 command from the client, settings of the port change */
+static void com_command(struct _uart_bridge *br)
+{
+    struct bridge_telnet *tn = &br->tn;
+    struct _uart *uart = br->uart;
+    unsigned char *v = tn->sb + 2;
+    unsigned char baud[4];
+    unsigned int rate;
+    int len = tn->sb_len - 2;
+    int val;
+
+    if (tn->sb_len < 2 || tn->sb[0] != TELNET_COM_PORT)
+        return;
+
+    val = len > 0 ? v[0] : 0;
+
+    switch (tn->sb[1]) {
+    case COM_SIGNATURE:
+        telnet_reply(br, COM_SIGNATURE, (const unsigned char *) LIBUART_NAME,
+                     strlen(LIBUART_NAME));
+        break;
+    case COM_SET_BAUDRATE:
+        if (len == 4) {
+            rate = ((unsigned int) v[0] << 24) | ((unsigned int) v[1] << 16) |
+                   ((unsigned int) v[2] << 8) | v[3];
+
+            if (rate != 0 && rate <= INT_MAX && uart_baud_valid(rate)) {
+                uart->baud = rate;
+                uart_init_baud(uart);
+            }
+        }
+
+        baud[0] = uart->baud >> 24;
+        baud[1] = uart->baud >> 16;
+        baud[2] = uart->baud >> 8;
+        baud[3] = uart->baud;
+        telnet_reply(br, COM_SET_BAUDRATE, baud, 4);
+        break;
+    case COM_SET_DATASIZE:
+        if (val >= 5 && val <= 8) {
+            uart->data_bits = val;
+            uart_init_databits(uart);
+        }
+
+        telnet_reply_byte(br, COM_SET_DATASIZE, uart->data_bits);
+        break;
+    case COM_SET_PARITY:
+        /* mark and space parity are not supported */
+        if (val >= 1 && val <= 3) {
+            uart->parity = val == 1 ? UART_PARITY_NO :
+                           val == 2 ? UART_PARITY_ODD : UART_PARITY_EVEN;
+            uart_init_parity(uart);
+        }
+
+        telnet_reply_byte(br, COM_SET_PARITY, com_parity(uart->parity));
+        break;
+    case COM_SET_STOPSIZE:
+        /* 1.5 stop bits (3) are not supported */
+        if (val == 1 || val == 2) {
+            uart->stop_bits = val;
+            uart_init_stopbits(uart);
+        }
+
+        telnet_reply_byte(br, COM_SET_STOPSIZE, uart->stop_bits);
+        break;
+    case COM_SET_CONTROL:
+        com_control(br, val);
+        break;
+    case COM_FLOW_SUSPEND:
+        tn->suspended = 1;
+        break;
+    case COM_FLOW_RESUME:
+        tn->suspended = 0;
+        break;
+    case COM_SET_LINESTATE_MASK:
+        tn->line_mask = val;
+        telnet_reply_byte(br, COM_SET_LINESTATE_MASK, val);
+        break;
+    case COM_SET_MODEMSTATE_MASK:
+        tn->modem_mask = val;
+        telnet_reply_byte(br, COM_SET_MODEMSTATE_MASK, val);
+        break;
+    case COM_PURGE_DATA:
+        if (val >= 1 && val <= 3)
+            tcflush(uart->fd, val == 1 ? TCIFLUSH :
+                    val == 2 ? TCOFLUSH : TCIOFLUSH);
+
+        telnet_reply_byte(br, COM_PURGE_DATA, val);
+        break;
+    }
+}
+
+/* strip the telnet protocol from client data, returns the data bytes */
+static int telnet_input(struct _uart_bridge *br, const unsigned char *in,
+                        int len, char *out)
+{
+    struct bridge_telnet *tn = &br->tn;
+    int n = 0;
+    int i;
+
+    for (i = 0; i < len; i++) {
+        unsigned char c = in[i];
+
+        switch (tn->state) {
+        case TELNET_DATA:
+            if (c == TELNET_IAC)
+                tn->state = TELNET_CMD;
+            else
+                out[n++] = c;
+
+            break;
+        case TELNET_CMD:
+            tn->state = TELNET_DATA;
+
+            if (c == TELNET_IAC) {
+                out[n++] = c;
+            } else if (c >= TELNET_WILL) {
+                tn->cmd = c;
+                tn->state = TELNET_OPT;
+            } else if (c == TELNET_SB) {
+                tn->sb_len = 0;
+                tn->state = TELNET_SUB;
+            }
+
+            break;
+        case TELNET_OPT:
+            telnet_option(br, tn->cmd, c);
+            tn->state = TELNET_DATA;
+            break;
+        case TELNET_SUB:
+            if (c == TELNET_IAC)
+                tn->state = TELNET_SUB_IAC;
+            else if (tn->sb_len < BRIDGE_SB_SIZE)
+                tn->sb[tn->sb_len++] = c;
+
+            break;
+        case TELNET_SUB_IAC:
+            if (c == TELNET_SE) {
+                com_command(br);
+                tn->state = TELNET_DATA;
+            } else {
+                if (tn->sb_len < BRIDGE_SB_SIZE)
+                    tn->sb[tn->sb_len++] = c;
+
+                tn->state = TELNET_SUB;
+            }
+
+            break;
+        }
+    }
+
+    return n;
+}
+
+/* report changed modem lines the client asked for (RFC 2217) */
+static void telnet_modem(struct _uart_bridge *br)
+{
+    struct bridge_telnet *tn = &br->tn;
+    unsigned char state = 0;
+    unsigned char delta;
+    int bits;
+
+    if (br->uart->be->get_pins(br->uart, &bits) == -1)
+        return;
+
+    if (bits & TIOCM_CTS)
+        state |= 0x10;
+
+    if (bits & TIOCM_DSR)
+        state |= 0x20;
+
+    if (bits & TIOCM_RI)
+        state |= 0x40;
+
+    if (bits & TIOCM_CD)
+        state |= 0x80;
+
+    delta = (state ^ tn->modem) >> 4;
+    tn->modem = state;
+
+    /* a line the client watches, or its delta bit, changed */
+    if (((delta << 4) | delta) & tn->modem_mask)
+        telnet_reply_byte(br, COM_NOTIFY_MODEMSTATE,
+                          (state | delta) & tn->modem_mask);
+}
+
+/* data of the port read by the bridge, NULL if it was spliced */
+static void bridge_rx(struct _uart_bridge *br, const void *buf, int len)
+{
+    if (buf && CAP_ACTIVE(br->uart))
+        cap_buf(br->uart, CAP_RX, (const char *) buf, len);
+
+    if (br->uart->lat)
+        lat_rx(br->uart);
+}
+
+/*
+ * Take data from the input of a direction, only called while nothing is
+ * waiting for the output. Returns the bytes read, 0 at the end of the
+ * input, -1 on errors (EAGAIN if nothing is there).
+ */
+static int bridge_fill(struct _uart_bridge *br, struct bridge_dir *d)
+{
+    unsigned char raw[BRIDGE_BUF_SIZE];
+    ssize_t n;
+    int i;
+
+    /*
+     * Nothing is waiting, so the mode can change here: a capture needs
+     * the data in user space and copies while it runs.
+     */
+    if (d->can_splice)
+        d->splice = !CAP_ACTIVE(br->uart);
+
+    if (d->splice) {
+        n = splice(d->in, NULL, d->pipe[1], NULL, BRIDGE_PIPE_SIZE,
+                   SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+
+        if (n > 0) {
+            d->len = n;
+
+            if (d == &br->up)
+                bridge_rx(br, NULL, n);
+        }
+
+        /* e.g. a driver without splice support, copy from now on */
+        if (n != -1 || errno != EINVAL)
+            return n;
+
+        d->splice = 0;
+        d->can_splice = 0;
+    }
+
+    if (!(br->flags & UART_BRIDGE_RFC2217)) {
+        n = read(d->in, d->buf, BRIDGE_BUF_SIZE);
+
+        if (n > 0) {
+            d->off = 0;
+            d->len = n;
+
+            if (d == &br->up)
+                bridge_rx(br, d->buf, n);
+        }
+
+        return n;
+    }
+
+    n = read(d->in, raw, sizeof(raw));
+
+    if (n <= 0)
+        return n;
+
+    if (d == &br->up) {
+        bridge_rx(br, raw, n);
+
+        /* IAC data bytes are sent twice */
+        for (i = 0; i < n; i++) {
+            bridge_append(d, &raw[i], 1);
+
+            if (raw[i] == TELNET_IAC)
+                bridge_append(d, &raw[i], 1);
+        }
+    } else {
+        d->off = 0;
+        d->len = telnet_input(br, raw, n, d->buf);
+    }
+
+    return n;
+}
+
+/* write what is waiting, returns the bytes written or -1 */
+static int bridge_flush(struct _uart_bridge *br, struct bridge_dir *d)
+{
+    struct _uart *uart = br->uart;
+    ssize_t n;
+    int total = 0;
+
+    while (d->len > 0) {
+        if (d->splice)
+            n = splice(d->pipe[0], NULL, d->out, NULL, d->len,
+                       SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+        else
+            n = write(d->out, d->buf + d->off, d->len);
+
+        if (n == -1) {
+            if (errno == EINTR)
+                continue;
+
+            if (errno == EAGAIN)
+                break;
+
+            return -1;
+        }
+
+        /* data written to the port is captured like uart_sendv() does */
+        if (d == &br->down && !d->splice && CAP_ACTIVE(uart))
+            cap_buf(uart, CAP_TX, d->buf + d->off, n);
+
+        d->len -= n;
+        total += n;
+
+        if (!d->splice)
+            d->off += n;
+    }
+
+    if (d->len == 0) {
+        d->off = 0;
+
+        if (d == &br->down && total > 0 && uart->lat)
+            lat_tx_done(uart);
+    }
+
+    return total;
+}
+
+static void bridge_drop(struct _uart_bridge *br)
+{
+    struct bridge_dir *d = &br->up;
+    char buf[BRIDGE_BUF_SIZE];
+
+    /* the data read for the client is lost with the connection */
+    if (d->splice)
+        while (read(d->pipe[0], buf, sizeof(buf)) > 0);
+
+    d->off = 0;
+    d->len = 0;
+    close(br->client_fd);
+    br->client_fd = -1;
+}
+
+static void bridge_accept(struct _uart_bridge *br)
+{
+    int one = 1;
+    int fd;
+
+    fd = accept4(br->listen_fd, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+
+    if (fd == -1)
+        return;
+
+    /* one client at a time, like a real serial line */
+    if (br->client_fd != -1) {
+        close(fd);
+        return;
+    }
+
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    br->client_fd = fd;
+    br->up.out = fd;
+    br->down.in = fd;
+
+    if (br->flags & UART_BRIDGE_RFC2217)
+        telnet_start(br);
+}
+
+/* the UART failed, returns 1 while the port reconnects */
+static int bridge_lost(struct _uart_bridge *br, int hangup)
+{
+    struct _uart *uart = br->uart;
+
+    if (uart->rc && (hangup || RECONNECT_ERRNO(errno)) &&
+        reconnect_lost(uart))
+        return 1;
+
+    if (hangup)
+        error_code(UART_ERR_IO, "UART device hung up");
+    else
+        error("UART I/O failed", 1);
+
+    return 0;
+}
+
+static void *bridge_thread(void *arg)
+{
+    struct _uart_bridge *br = (struct _uart_bridge *) arg;
+    struct bridge_telnet *tn = &br->tn;
+    struct pollfd pfd[4];
+    sigset_t set;
+    int rfc2217 = br->flags & UART_BRIDGE_RFC2217;
+    int timeout;
+    int paused = 0;
+    int ret;
+
+    /* a client closing the connection must not kill the process */
+    sigemptyset(&set);
+    sigaddset(&set, SIGPIPE);
+    pthread_sigmask(SIG_BLOCK, &set, NULL);
+    pfd[0].fd = br->stop_fd;
+    pfd[0].events = POLLIN;
+    pfd[1].fd = br->listen_fd;
+    pfd[1].events = POLLIN;
+
+    while (1) {
+        if (paused && !reconnect_pending(br->uart))
+            paused = 0;
+
+        pfd[2].fd = br->client_fd;
+        pfd[2].events = 0;
+        pfd[3].fd = paused ? -1 : br->uart->fd;
+        pfd[3].events = 0;
+
+        /* a direction reads only after its output took everything */
+        if (br->client_fd != -1) {
+            if (br->up.len > 0)
+                pfd[2].events |= POLLOUT;
+            else if (!tn->suspended)
+                pfd[3].events |= POLLIN;
+
+            if (br->down.len == 0)
+                pfd[2].events |= POLLIN;
+        }
+
+        if (br->down.len > 0)
+            pfd[3].events |= POLLOUT;
+
+        timeout = paused || (rfc2217 && tn->modem_mask &&
+                             br->client_fd != -1) ? BRIDGE_POLL_MS : -1;
+        ret = poll(pfd, 4, timeout);
+
+        if (ret == -1) {
+            if (errno == EINTR)
+                continue;
+
+            error("poll() failed", 1);
+            break;
+        }
+
+        if (pfd[0].revents)
+            break;
+
+        if (pfd[1].revents & POLLIN)
+            bridge_accept(br);
+
+        if (pfd[3].revents & POLLIN) {
+            ret = bridge_fill(br, &br->up);
+
+            if (ret > 0) {
+                STATS_ADD(br->uart, rx_bytes, ret);
+            } else if (ret == 0 ? (pfd[3].revents & (POLLHUP | POLLERR)) :
+                       errno != EAGAIN) {
+                /* a hung up tty reads as end of file */
+                if (!bridge_lost(br, ret == 0))
+                    break;
+
+                paused = 1;
+            }
+        } else if (pfd[3].revents & (POLLHUP | POLLERR) &&
+                   !(pfd[3].revents & POLLOUT)) {
+            if (!bridge_lost(br, 1))
+                break;
+
+            paused = 1;
+        }
+
+        if (pfd[2].revents & POLLIN) {
+            ret = bridge_fill(br, &br->down);
+
+            if (ret == 0 || (ret == -1 && errno != EAGAIN)) {
+                bridge_drop(br);
+                continue;
+            }
+        } else if (pfd[2].revents & (POLLHUP | POLLERR)) {
+            bridge_drop(br);
+            continue;
+        }
+
+        if (br->client_fd != -1) {
+            if (rfc2217 && tn->modem_mask)
+                telnet_modem(br);
+
+            if (bridge_flush(br, &br->up) == -1) {
+                bridge_drop(br);
+                continue;
+            }
+        }
+
+        if (!paused && br->down.len > 0) {
+            ret = bridge_flush(br, &br->down);
+
+            if (ret > 0) {
+                STATS_ADD(br->uart, tx_bytes, ret);
+            } else if (ret == -1) {
+                if (!bridge_lost(br, 0))
+                    break;
+
+                paused = 1;
+            }
+        }
+    }
+
+    if (br->client_fd != -1)
+        bridge_drop(br);
+
+    return NULL;
+}
+
+/* "/path" is a Unix socket, "[host]:port" a TCP socket */
+static int bridge_listen(struct _uart_bridge *br, const char *addr)
+{
+    struct sockaddr_un un;
+    struct addrinfo hints;
+    struct addrinfo *res;
+    struct addrinfo *ai;
+    char host[256];
+    const char *port;
+    int one = 1;
+    int fd = -1;
+    int ret;
+
+    if (addr[0] == '/') {
+        if (strlen(addr) >= sizeof(un.sun_path)) {
+            error_code(UART_ERR_INVAL, "socket path too long");
+            return -1;
+        }
+
+        fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+
+        if (fd == -1) {
+            error("socket() failed", 1);
+            return -1;
+        }
+
+        memset(&un, 0, sizeof(un));
+        un.sun_family = AF_UNIX;
+        strcpy(un.sun_path, addr);
+
+        if (bind(fd, (struct sockaddr *) &un, sizeof(un)) == -1) {
+            error("bind() failed", 1);
+            close(fd);
+            return -1;
+        }
+
+        strcpy(br->path, addr);
+    } else {
+        port = strrchr(addr, ':');
+
+        if (!port || (size_t) (port - addr) >= sizeof(host) || !port[1]) {
+            error_code(UART_ERR_INVAL, "invalid socket address");
+            return -1;
+        }
+
+        memcpy(host, addr, port - addr);
+        host[port - addr] = '\0';
+        port++;
+        memset(&hints, 0, sizeof(hints));
+        hints.ai_family = AF_UNSPEC;
+        hints.ai_socktype = SOCK_STREAM;
+        hints.ai_flags = AI_PASSIVE;
+        ret = getaddrinfo(host[0] ? host : NULL, port, &hints, &res);
+
+        if (ret != 0) {
+            error_code(UART_ERR_INVAL, gai_strerror(ret));
+            return -1;
+        }
+
+        for (ai = res; ai; ai = ai->ai_next) {
+            fd = socket(ai->ai_family,
+                        ai->ai_socktype | SOCK_NONBLOCK | SOCK_CLOEXEC,
+                        ai->ai_protocol);
+
+            if (fd == -1)
+                continue;
+
+            setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+            if (bind(fd, ai->ai_addr, ai->ai_addrlen) == 0)
+                break;
+
+            close(fd);
+            fd = -1;
+        }
+
+        freeaddrinfo(res);
+
+        if (fd == -1) {
+            error("bind() failed", 1);
+            return -1;
+        }
+    }
+
+    if (listen(fd, 1) == -1) {
+        error("listen() failed", 1);
+        close(fd);
+
+        if (br->path[0])
+            unlink(br->path);
+
+        return -1;
+    }
+
+    br->listen_fd = fd;
+    return 0;
+}
+
+static int bridge_dir_init(struct bridge_dir *d, int in, int out, int splice)
+{
+    d->in = in;
+    d->out = out;
+    d->pipe[0] = -1;
+    d->pipe[1] = -1;
+    d->buf = (char *) malloc(BRIDGE_OUT_SIZE);
+
+    if (!d->buf) {
+        error("malloc() failed", 1);
+        return -1;
+    }
+
+    if (splice) {
+        if (pipe2(d->pipe, O_NONBLOCK | O_CLOEXEC) == -1) {
+            error("pipe2() failed", 1);
+            return -1;
+        }
+
+        d->splice = 1;
+        d->can_splice = 1;
+    }
+
+    return 0;
+}
+
+static void bridge_dir_free(struct bridge_dir *d)
+{
+    if (d->pipe[0] != -1) {
+        close(d->pipe[0]);
+        close(d->pipe[1]);
+    }
+
+    free(d->buf);
+}
+
+static void bridge_free(struct _uart_bridge *br)
+{
+    bridge_dir_free(&br->up);
+    bridge_dir_free(&br->down);
+
+    if (br->stop_fd != -1)
+        close(br->stop_fd);
+
+    if (br->listen_fd != -1) {
+        close(br->listen_fd);
+
+        if (br->path[0])
+            unlink(br->path);
+    }
+
+    free(br);
+}
+
+struct _uart_bridge *bridge_create(struct _uart *uart, const char *addr,
+                                   int flags)
+{
+    struct _uart_bridge *br;
+    int splice = !(flags & UART_BRIDGE_RFC2217);
+    int ret;
+
+    br = (struct _uart_bridge *) calloc(1, sizeof(*br));
+
+    if (!br) {
+        error("calloc() failed", 1);
+        return NULL;
+    }
+
+    br->uart = uart;
+    br->flags = flags;
+    br->listen_fd = -1;
+    br->client_fd = -1;
+    br->up.pipe[0] = -1;
+    br->down.pipe[0] = -1;
+    br->stop_fd = eventfd(0, EFD_CLOEXEC);
+
+    if (br->stop_fd == -1) {
+        error("eventfd() failed", 1);
+        bridge_free(br);
+        return NULL;
+    }
+
+    /* telnet escaping needs the data in user space */
+    if (bridge_dir_init(&br->up, uart->fd, -1, splice) == -1 ||
+        bridge_dir_init(&br->down, -1, uart->fd, splice) == -1 ||
+        bridge_listen(br, addr) == -1) {
+        bridge_free(br);
+        return NULL;
+    }
+
+    ret = pthread_create(&br->thread, NULL, bridge_thread, br);
+
+    if (ret != 0) {
+        errno = ret;
+        error("pthread_create() failed", 1);
+        bridge_free(br);
+        return NULL;
+    }
+
+    uart->bridge = br;
+    return br;
+}
+
+void bridge_destroy(struct _uart_bridge *br)
+{
+    uint64_t one = 1;
+
+    if (write(br->stop_fd, &one, sizeof(one)) == -1)
+        error("write() failed", 1);
+
+    pthread_join(br->thread, NULL);
+    br->uart->bridge = NULL;
+    bridge_free(br);
+}
@@ -0,0 +1,80 @@
+/**
+ *
+ * File Name: unix/bridge.h
+ * Title    : UNIX UART serial to socket bridge
+ * Project  : libUART
+ * Author   : Copyright (C) 2018-2020 Johannes Krottmayer <krjdev@gmail.com>
+ * Created  : 2026-10-19
+ * Modified :
+ * Revised  :
+ * Version  : 0.1.0.0
+ * License  : ISC (see file LICENSE.txt)
+ *
+ * NOTE: This code is currently below version 1.0, and therefore is considered
+ * to be lacking in some functionality or documentation, or may not be fully
+ * tested. Nonetheless, you can expect most functions to work.
+ *
+ */
+
+#ifndef LIBUART_UNIX_BRIDGE_H
+#define LIBUART_UNIX_BRIDGE_H
+
+#include <pthread.h>
+
+#include "../libUART.h"
+#include "uart.h"
+
+/* bytes moved by one splice() */
+#define BRIDGE_PIPE_SIZE    65536
+/* bytes moved by one read() without splice() */
+#define BRIDGE_BUF_SIZE     4096
+/* telnet escaping may double the data, replies need some more room */
+#define BRIDGE_OUT_SIZE     (4 * BRIDGE_BUF_SIZE)
+/* polling interval for modem lines and a reconnecting port */
+#define BRIDGE_POLL_MS      100
+/* longest RFC 2217 subnegotiation accepted */
+#define BRIDGE_SB_SIZE      64
+
+/* one direction of the bridge */
+struct bridge_dir {
+    int in;
+    int out;
+    int splice;                 /* data moves through the pipe */
+    int can_splice;             /* the pipe is set up and splice() works */
+    int pipe[2];
+    char *buf;                  /* data if not spliced */
+    int off;
+    int len;                    /* bytes waiting for 'out' */
+};
+
+/* RFC 2217 (telnet COM port control) state of the connection */
+struct bridge_telnet {
+    int state;
+    unsigned char cmd;
+    unsigned char opt[256];     /* TELNET_OPT_* flags */
+    unsigned char sb[BRIDGE_SB_SIZE];
+    int sb_len;
+    int suspended;              /* client asked to stop the data flow */
+    unsigned char line_mask;
+    unsigned char modem_mask;
+    unsigned char modem;        /* last modem state sent */
+};
+
+struct _uart_bridge {
+    struct _uart *uart;
+    int flags;
+    int listen_fd;
+    int client_fd;
+    int stop_fd;
+    char path[108];             /* Unix socket to remove, empty for TCP */
+    pthread_t thread;
+    struct bridge_dir up;       /* UART to client */
+    struct bridge_dir down;     /* client to UART */
+    struct bridge_telnet tn;
+};
+
+extern struct _uart_bridge *bridge_create(struct _uart *uart, const char *addr,
+                                          int flags);
+extern void bridge_destroy(struct _uart_bridge *br);
+
+#endif
@@ -0,0 +1,95 @@
+/**
+ *
+ * File Name: unix/bulk.c
+ * Title    : UNIX UART parallel open
+ * Project  : libUART
+ * Author   : Copyright (C) 2018-2020 Johannes Krottmayer <krjdev@gmail.com>
+ * Created  : 2026-10-19
+ * Modified :
+ * Revised  :
+ * Version  : 0.1.0.0
+ * License  : ISC (see file LICENSE.txt)
+ *
+ * NOTE: This code is currently below version 1.0, and therefore is considered
+ * to be lacking in some functionality or documentation, or may not be fully
+ * tested. Nonetheless, you can expect most functions to work.
+ *
+ */
+
+#include <pthread.h>
+#include <stdatomic.h>
+
+#include "error.h"
+#include "bulk.h"
+
+struct bulk {
+    const char **devs;
+    int num;
+    int baud;
+    const char *opt;
+    uart_t **uart;
+    int *status;
+    atomic_int next;
+    atomic_int opened;
+};
+
+/* workers take the next device until the list is exhausted */
+static void *bulk_worker(void *arg)
+{
+    struct bulk *b = (struct bulk *) arg;
+    int code;
+    int i;
+
+    while ((i = atomic_fetch_add(&b->next, 1)) < b->num) {
+        b->uart[i] = libUART_open(b->devs[i], b->baud, b->opt);
+
+        if (b->uart[i]) {
+            atomic_fetch_add(&b->opened, 1);
+            code = UART_ERR_NONE;
+        } else {
+            /* every failed open records its reason in this thread */
+            code = error_last(NULL);
+
+            if (code == UART_ERR_NONE)
+                code = UART_ERR_IO;
+        }
+
+        if (b->status)
+            b->status[i] = code;
+    }
+
+    return NULL;
+}
+
+int bulk_open(const char **devs, int num, int baud, const char *opt,
+              uart_t **uart, int *status)
+{
+    pthread_t thread[BULK_MAX_THREADS];
+    struct bulk b;
+    int threads;
+    int n = 0;
+
+    b.devs = devs;
+    b.num = num;
+    b.baud = baud;
+    b.opt = opt;
+    b.uart = uart;
+    b.status = status;
+    atomic_init(&b.next, 0);
+    atomic_init(&b.opened, 0);
+
+    /* the calling thread is a worker as well */
+    threads = num - 1 < BULK_MAX_THREADS ? num - 1 : BULK_MAX_THREADS;
+
+    for (n = 0; n < threads; n++) {
+        if (pthread_create(&thread[n], NULL, bulk_worker, &b) != 0)
+            break;
+    }
+
+    bulk_worker(&b);
+
+    while (n > 0)
+        pthread_join(thread[--n], NULL);
+
+    return atomic_load(&b.opened);
+}
@@ -0,0 +1,34 @@
+/**
+ *
+ * File Name: unix/bulk.h
+ * Title    : UNIX UART parallel open
+ * Project  : libUART
+ * Author   : Copyright (C) 2018-2020 Johannes Krottmayer <krjdev@gmail.com>
+ * Created  : 2026-10-19
+ * Modified :
+ * Revised  :
+ * Version  : 0.1.0.0
+ * License  : ISC (see file LICENSE.txt)
+ *
+ * NOTE: This code is currently below version 1.0, and therefore is considered
+ * to be lacking in some functionality or documentation, or may not be fully
+ * tested. Nonetheless, you can expect most functions to work.
+ *
+ */
+
+#ifndef LIBUART_UNIX_BULK_H
+#define LIBUART_UNIX_BULK_H
+
+#include "../libUART.h"
+
+/*
+ * Upper limit of threads opening ports at the same time. Opening a
+ * USB-serial adapter mostly waits for USB control transfers, so this
+ * is deliberately not tied to the number of CPUs.
+ */
+#define BULK_MAX_THREADS    32
+
+extern int bulk_open(const char **devs, int num, int baud, const char *opt,
+                     uart_t **uart, int *status);
+
+#endif
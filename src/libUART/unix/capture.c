@@ -0,0 +1,240 @@
+/**
+ *
+ * File Name: unix/capture.c
+ * Title    : UNIX UART wire capture
+ * Project  : libUART
+ * Author   : Copyright (C) 2018-2020 Johannes Krottmayer <krjdev@gmail.com>
+ * Created  : 2026-10-19
+ * Modified :
+ * Revised  :
+ * Version  : 0.1.0.0
+ * License  : ISC (see file LICENSE.txt)
+ *
+ * NOTE: This code is currently below version 1.0, and therefore is considered
+ * to be lacking in some functionality or documentation, or may not be fully
+ * tested. Nonetheless, you can expect most functions to work.
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <time.h>
+#include <unistd.h>
+#include <sched.h>
+#include <sys/mman.h>
+
+#include "error.h"
+#include "uart.h"
+#include "stats.h"
+#include "capture.h"
+
+static void cap_free(struct capture *c)
+{
+    int i;
+
+    for (i = 0; i < c->segments; i++) {
+        if (c->map[i])
+            munmap(c->map[i], c->seg_size);
+    }
+
+    pthread_mutex_destroy(&c->lock);
+    free(c->map);
+    free(c);
+}
+
+/* all segments are allocated and mapped up front, a roll-over is free */
+static char *cap_map(const char *path, int idx, size_t seg_size)
+{
+    char name[DEV_NAME_LEN + 16];
+    char *map;
+    int ret;
+    int fd;
+
+    snprintf(name, sizeof(name), "%s.%d", path, idx);
+    fd = open(name, O_RDWR | O_CREAT | O_TRUNC, 0644);
+
+    if (fd == -1) {
+        error("open() failed", 1);
+        return NULL;
+    }
+
+    /* reserve the blocks now instead of faulting on a full disk later */
+    ret = posix_fallocate(fd, 0, seg_size);
+
+    if (ret != 0) {
+        errno = ret;
+        error("posix_fallocate() failed", 1);
+        close(fd);
+        return NULL;
+    }
+
+    map = (char *) mmap(NULL, seg_size, PROT_READ | PROT_WRITE, MAP_SHARED,
+                        fd, 0);
+    close(fd);
+
+    if (map == MAP_FAILED) {
+        error("mmap() failed", 1);
+        return NULL;
+    }
+
+    return map;
+}
+
+static void cap_begin_segment(struct capture *c)
+{
+    struct cap_seg *seg = (struct cap_seg *) c->map[c->cur];
+    struct timespec ts;
+
+    seg->magic = CAP_MAGIC;
+    seg->version = CAP_VERSION;
+    seg->seq = c->seq++;
+    __atomic_store_n(&seg->used, CAP_HDR_SIZE, __ATOMIC_RELEASE);
+    seg->mono_ns = stats_now_ns();
+    clock_gettime(CLOCK_REALTIME, &ts);
+    seg->real_ns = (int64_t) ts.tv_sec * 1000000000LL + ts.tv_nsec;
+    c->off = CAP_HDR_SIZE;
+}
+
+int cap_start(struct _uart *uart, const char *path, size_t seg_size,
+              int segments)
+{
+    struct capture *old = NULL;
+    struct capture *c;
+    int i;
+
+    if (atomic_load(&uart->cap)) {
+        error_code(UART_ERR_STATE, "capture already running");
+        return -1;
+    }
+
+    c = (struct capture *) calloc(1, sizeof(*c));
+
+    if (!c) {
+        error("calloc() failed", 1);
+        return -1;
+    }
+
+    c->map = (char **) calloc(segments, sizeof(char *));
+
+    if (!c->map) {
+        error("calloc() failed", 1);
+        free(c);
+        return -1;
+    }
+
+    /* padded records must end inside the segment */
+    seg_size &= ~((size_t) CAP_ALIGN - 1);
+    pthread_mutex_init(&c->lock, NULL);
+    c->segments = segments;
+    c->seg_size = seg_size;
+
+    for (i = 0; i < segments; i++) {
+        c->map[i] = cap_map(path, i, seg_size);
+
+        if (!c->map[i]) {
+            cap_free(c);
+            return -1;
+        }
+    }
+
+    cap_begin_segment(c);
+
+    /* another thread may have started a capture meanwhile */
+    if (!atomic_compare_exchange_strong(&uart->cap, &old, c)) {
+        cap_free(c);
+        error_code(UART_ERR_STATE, "capture already running");
+        return -1;
+    }
+
+    return 0;
+}
+
+/*
+ * The reader thread, pool workers and the bridge may be recording while
+ * the capture is stopped. Once it is unpublished, no new record can
+ * start on it, so it is freed as soon as the records in progress end.
+ */
+void cap_stop(struct _uart *uart)
+{
+    struct capture *c;
+
+    c = atomic_exchange(&uart->cap, NULL);
+
+    if (!c)
+        return;
+
+    while (atomic_load(&uart->cap_users) > 0)
+        sched_yield();
+
+    cap_free(c);
+}
+
+/*
+ * Append one chunk. The only shared state is the write position, the
+ * mutex is uncontended unless two threads move data on the same port
+ * at the same moment, so a record costs a time stamp and a memcpy.
+ */
+void cap_record(struct _uart *uart, int dir, const struct iovec *iov,
+                int cnt, size_t len)
+{
+    struct capture *c;
+    struct cap_rec *rec;
+    struct cap_seg *seg;
+    size_t max;
+    size_t n;
+    char *p;
+    int i;
+
+    /* announce the record before looking at the capture */
+    atomic_fetch_add(&uart->cap_users, 1);
+    c = atomic_load(&uart->cap);
+
+    if (!c) {
+        atomic_fetch_sub(&uart->cap_users, 1);
+        return;
+    }
+
+    max = c->seg_size - CAP_HDR_SIZE - sizeof(struct cap_rec);
+    n = len > max ? max : len;
+
+    pthread_mutex_lock(&c->lock);
+
+    if (c->off + CAP_PAD(sizeof(struct cap_rec) + n) > c->seg_size) {
+        c->cur = (c->cur + 1) % c->segments;
+        cap_begin_segment(c);
+    }
+
+    seg = (struct cap_seg *) c->map[c->cur];
+    rec = (struct cap_rec *) (c->map[c->cur] + c->off);
+    rec->len = n;
+    rec->dir = dir;
+    rec->reserved = 0;
+    rec->port = uart->id;
+    rec->orig_len = len;
+    rec->ts_ns = stats_now_ns();
+    p = (char *) (rec + 1);
+
+    for (i = 0; i < cnt && n > 0; i++) {
+        len = iov[i].iov_len < n ? iov[i].iov_len : n;
+        memcpy(p, iov[i].iov_base, len);
+        p += len;
+        n -= len;
+    }
+
+    c->off += CAP_PAD(sizeof(struct cap_rec) + rec->len);
+    __atomic_store_n(&seg->used, c->off, __ATOMIC_RELEASE);
+    pthread_mutex_unlock(&c->lock);
+    atomic_fetch_sub(&uart->cap_users, 1);
+}
+
+void cap_buf(struct _uart *uart, int dir, const char *buf, size_t len)
+{
+    struct iovec iov;
+
+    iov.iov_base = (void *) buf;
+    iov.iov_len = len;
+    cap_record(uart, dir, &iov, 1, len);
+}
@@ -0,0 +1,87 @@
+/**
+ *
+ * File Name: unix/capture.h
+ * Title    : UNIX UART wire capture
+ * Project  : libUART
+ * Author   : Copyright (C) 2018-2020 Johannes Krottmayer <krjdev@gmail.com>
+ * Created  : 2026-10-19
+ * Modified :
+ * Revised  :
+ * Version  : 0.1.0.0
+ * License  : ISC (see file LICENSE.txt)
+ *
+ * NOTE: This code is currently below version 1.0, and therefore is considered
+ * to be lacking in some functionality or documentation, or may not be fully
+ * tested. Nonetheless, you can expect most functions to work.
+ *
+ */
+
+#ifndef LIBUART_UNIX_CAPTURE_H
+#define LIBUART_UNIX_CAPTURE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <sys/uio.h>
+
+#define CAP_MAGIC           0x50435455  /* "UTCP" */
+#define CAP_VERSION         1
+#define CAP_HDR_SIZE        64          /* records start here */
+#define CAP_ALIGN           8
+#define CAP_MIN_SEG_SIZE    4096
+
+#define CAP_PAD(n)          (((n) + CAP_ALIGN - 1) & ~((size_t) CAP_ALIGN - 1))
+
+#define CAP_RX              0
+#define CAP_TX              1
+
+/* cheap test for the I/O paths, cap_record() checks again */
+#define CAP_ACTIVE(uart) \
+    (atomic_load_explicit(&(uart)->cap, memory_order_relaxed) != NULL)
+
+/*
+ * A capture is a set of equally sized segment files <path>.0 ... <path>.N-1
+ * used round-robin. Each segment starts with a cap_seg header. Segments
+ * with a higher 'seq' are newer. 'used' is the end of the last complete
+ * record and is updated after the record has been written. Every record
+ * is a cap_rec followed by 'len' payload bytes, padded to CAP_ALIGN.
+ */
+struct cap_seg {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t seq;
+    uint64_t used;
+    int64_t mono_ns;        /* CLOCK_MONOTONIC when the segment started */
+    int64_t real_ns;        /* CLOCK_REALTIME at the same moment */
+};
+
+struct cap_rec {
+    uint32_t len;
+    uint16_t dir;
+    uint16_t reserved;
+    uint32_t port;
+    uint32_t orig_len;      /* chunk length before clipping to a segment */
+    int64_t ts_ns;          /* CLOCK_MONOTONIC */
+};
+
+struct _uart;
+
+struct capture {
+    pthread_mutex_t lock;
+    int segments;
+    size_t seg_size;
+    char **map;
+    int cur;
+    uint64_t seq;
+    size_t off;
+};
+
+extern int cap_start(struct _uart *uart, const char *path, size_t seg_size,
+                     int segments);
+extern void cap_stop(struct _uart *uart);
+extern void cap_record(struct _uart *uart, int dir, const struct iovec *iov,
+                       int cnt, size_t len);
+extern void cap_buf(struct _uart *uart, int dir, const char *buf, size_t len);
+
+#endif
@@ -0,0 +1,314 @@
+/**
+ *
+ * File Name: unix/enum.c
+ * Title    : UNIX UART device enumeration
+ * Project  : libUART
+ * Author   : Copyright (C) 2018-2020 Johannes Krottmayer <krjdev@gmail.com>
+ * Created  : 2026-10-19
+ * Modified :
+ * Revised  :
+ * Version  : 0.1.0.0
+ * License  : ISC (see file LICENSE.txt)
+ *
+ * NOTE: This code is currently below version 1.0, and therefore is considered
+ * to be lacking in some functionality or documentation, or may not be fully
+ * tested. Nonetheless, you can expect most functions to work.
+ *
+ */
+
+/* strverscmp() */
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <dirent.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#include "error.h"
+#include "enum.h"
+
+/*
+ * Scanning sysfs costs a few hundred system calls per device, so the
+ * result is kept until udev or devtmpfs add or remove a device node.
+ */
+static struct {
+    pthread_mutex_t lock;
+    int valid;
+    struct timespec dev_mtime;
+    struct timespec by_id_mtime;
+    struct uart_port_info *port;
+    int num;
+} g_cache = { PTHREAD_MUTEX_INITIALIZER, 0, {0, 0}, {0, 0}, NULL, 0 };
+
+/* read a sysfs attribute without the trailing newline */
+static int enum_read(const char *dir, const char *attr, char *buf, size_t size)
+{
+    char path[PATH_MAX];
+    FILE *f;
+    size_t len;
+
+    snprintf(path, sizeof(path), "%s/%s", dir, attr);
+    f = fopen(path, "r");
+
+    if (!f)
+        return -1;
+
+    if (!fgets(buf, size, f)) {
+        fclose(f);
+        return -1;
+    }
+
+    fclose(f);
+    len = strlen(buf);
+
+    while (len > 0 && (buf[len - 1] == '\n' || buf[len - 1] == ' '))
+        buf[--len] = '\0';
+
+    return 0;
+}
+
+/* name of the target of a symbolic link, e.g. the driver of a device */
+static int enum_link(const char *dir, const char *link, char *buf,
+                     size_t size)
+{
+    char path[PATH_MAX];
+    char target[PATH_MAX];
+    const char *name;
+    ssize_t len;
+
+    snprintf(path, sizeof(path), "%s/%s", dir, link);
+    len = readlink(path, target, sizeof(target) - 1);
+
+    if (len == -1)
+        return -1;
+
+    target[len] = '\0';
+    name = strrchr(target, '/');
+    snprintf(buf, size, "%s", name ? name + 1 : target);
+    return 0;
+}
+
+/* strip the last component of a sysfs path, returns -1 at the top */
+static int enum_parent(char *path)
+{
+    char *slash = strrchr(path, '/');
+
+    if (!slash || strncmp(path, ENUM_SYS_DEVICES,
+                          strlen(ENUM_SYS_DEVICES)) != 0 ||
+        (size_t) (slash - path) <= strlen(ENUM_SYS_DEVICES))
+        return -1;
+
+    (*slash) = '\0';
+    return 0;
+}
+
+/*
+ * Walk up from the tty's device to the USB interface and the USB device
+ * above it. The first driver found that is not the serial core's own
+ * "port" driver is the one of the device.
+ */
+static void enum_device(const char *tty, struct uart_port_info *info)
+{
+    char link[PATH_MAX];
+    char path[PATH_MAX];
+    char buf[128];
+
+    snprintf(link, sizeof(link), "%s/device", tty);
+
+    if (!realpath(link, path))
+        return;
+
+    do {
+        if (info->driver[0] == '\0' &&
+            enum_link(path, "driver", info->driver,
+                      sizeof(info->driver)) == 0 &&
+            enum_link(path, "subsystem", buf, sizeof(buf)) == 0 &&
+            strcmp(buf, "serial-base") == 0)
+            info->driver[0] = '\0';
+
+        if (info->interface == -1 &&
+            enum_read(path, "bInterfaceNumber", buf, sizeof(buf)) == 0)
+            info->interface = (int) strtol(buf, NULL, 16);
+
+        if (enum_read(path, "idVendor", buf, sizeof(buf)) == 0) {
+            info->vid = (int) strtol(buf, NULL, 16);
+
+            if (enum_read(path, "idProduct", buf, sizeof(buf)) == 0)
+                info->pid = (int) strtol(buf, NULL, 16);
+
+            enum_read(path, "serial", info->serial, sizeof(info->serial));
+            break;
+        }
+    } while (enum_parent(path) == 0);
+}
+
+static void enum_by_id(struct uart_port_info *port, int num)
+{
+    char path[PATH_MAX];
+    char target[PATH_MAX];
+    struct dirent *e;
+    DIR *dir;
+    int i;
+
+    dir = opendir(ENUM_BY_ID);
+
+    if (!dir)
+        return;
+
+    while ((e = readdir(dir))) {
+        if (e->d_name[0] == '.')
+            continue;
+
+        snprintf(path, sizeof(path), "%s/%s", ENUM_BY_ID, e->d_name);
+
+        if (!realpath(path, target))
+            continue;
+
+        for (i = 0; i < num; i++) {
+            if (strcmp(port[i].dev, target) == 0) {
+                if (strlen(path) < sizeof(port[i].by_id))
+                    strcpy(port[i].by_id, path);
+
+                break;
+            }
+        }
+    }
+
+    closedir(dir);
+}
+
+static int enum_cmp(const void *a, const void *b)
+{
+    const struct uart_port_info *x = (const struct uart_port_info *) a;
+    const struct uart_port_info *y = (const struct uart_port_info *) b;
+
+    return strverscmp(x->dev, y->dev);
+}
+
+static int enum_scan(struct uart_port_info **port, int *num)
+{
+    struct uart_port_info *p = NULL;
+    struct uart_port_info *tmp;
+    char tty[PATH_MAX];
+    char dev[PATH_MAX];
+    char buf[32];
+    struct dirent *e;
+    DIR *dir;
+    int n = 0;
+
+    dir = opendir(ENUM_SYS_TTY);
+
+    if (!dir) {
+        error("opendir() failed", 1);
+        return -1;
+    }
+
+    while ((e = readdir(dir))) {
+        if (e->d_name[0] == '.' ||
+            strlen("/dev/") + strlen(e->d_name) >= sizeof(p->dev))
+            continue;
+
+        snprintf(tty, sizeof(tty), "%s/%s", ENUM_SYS_TTY, e->d_name);
+
+        if (snprintf(dev, sizeof(dev), "%s/device", tty) >= (int) sizeof(dev))
+            continue;
+
+        /* consoles, ptys and other virtual ttys have no device */
+        if (access(dev, F_OK) == -1)
+            continue;
+
+        /* serial core ports without a detected UART (PORT_UNKNOWN) */
+        if (enum_read(tty, "type", buf, sizeof(buf)) == 0 &&
+            strcmp(buf, "0") == 0)
+            continue;
+
+        tmp = (struct uart_port_info *) realloc(p, (n + 1) * sizeof(*p));
+
+        if (!tmp) {
+            error("realloc() failed", 1);
+            closedir(dir);
+            free(p);
+            return -1;
+        }
+
+        p = tmp;
+        memset(&p[n], 0, sizeof(*p));
+        strcpy(p[n].dev, "/dev/");
+        strcat(p[n].dev, e->d_name);
+        p[n].vid = -1;
+        p[n].pid = -1;
+        p[n].interface = -1;
+        enum_device(tty, &p[n]);
+        n++;
+    }
+
+    closedir(dir);
+    enum_by_id(p, n);
+
+    if (n > 1)
+        qsort(p, n, sizeof(*p), enum_cmp);
+
+    (*port) = p;
+    (*num) = n;
+    return 0;
+}
+
+static void enum_mtime(const char *path, struct timespec *ts)
+{
+    struct stat st;
+
+    if (stat(path, &st) == 0) {
+        (*ts) = st.st_mtim;
+    } else {
+        ts->tv_sec = 0;
+        ts->tv_nsec = 0;
+    }
+}
+
+static int enum_same(const struct timespec *a, const struct timespec *b)
+{
+    return a->tv_sec == b->tv_sec && a->tv_nsec == b->tv_nsec;
+}
+
+int enum_ports(struct uart_port_info *ports, int max)
+{
+    struct uart_port_info *port;
+    struct timespec dev_mtime;
+    struct timespec by_id_mtime;
+    int num;
+    int ret;
+
+    pthread_mutex_lock(&g_cache.lock);
+    enum_mtime("/dev", &dev_mtime);
+    enum_mtime(ENUM_BY_ID, &by_id_mtime);
+
+    if (!g_cache.valid || !enum_same(&dev_mtime, &g_cache.dev_mtime) ||
+        !enum_same(&by_id_mtime, &g_cache.by_id_mtime)) {
+        if (enum_scan(&port, &num) == -1) {
+            pthread_mutex_unlock(&g_cache.lock);
+            return -1;
+        }
+
+        free(g_cache.port);
+        g_cache.port = port;
+        g_cache.num = num;
+        g_cache.dev_mtime = dev_mtime;
+        g_cache.by_id_mtime = by_id_mtime;
+        g_cache.valid = 1;
+    }
+
+    ret = g_cache.num;
+
+    if (max > ret)
+        max = ret;
+
+    if (max > 0)
+        memcpy(ports, g_cache.port, max * sizeof(*ports));
+
+    pthread_mutex_unlock(&g_cache.lock);
+    return ret;
+}
@@ -0,0 +1,30 @@
+/**
+ *
+ * File Name: unix/enum.h
+ * Title    : UNIX UART device enumeration
+ * Project  : libUART
+ * Author   : Copyright (C) 2018-2020 Johannes Krottmayer <krjdev@gmail.com>
+ * Created  : 2026-10-19
+ * Modified :
+ * Revised  :
+ * Version  : 0.1.0.0
+ * License  : ISC (see file LICENSE.txt)
+ *
+ * NOTE: This code is currently below version 1.0, and therefore is considered
+ * to be lacking in some functionality or documentation, or may not be fully
+ * tested. Nonetheless, you can expect most functions to work.
+ *
+ */
+
+#ifndef LIBUART_UNIX_ENUM_H
+#define LIBUART_UNIX_ENUM_H
+
+#include "../libUART.h"
+
+#define ENUM_SYS_TTY        "/sys/class/tty"
+#define ENUM_SYS_DEVICES    "/sys/devices"
+#define ENUM_BY_ID          "/dev/serial/by-id"
+
+extern int enum_ports(struct uart_port_info *ports, int max);
+
+#endif
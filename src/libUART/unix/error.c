@@ -5,9 +5,9 @@
  * Project  : libUART
  * Author   : Copyright (C) 2018-2020 Johannes Krottmayer <krjdev@gmail.com>
  * Created  : 2019-11-20
- * Modified : 
+ * Modified : 2026-10-19
  * Revised  : 
- * Version  : 0.1.0.0
+ * Version  : 0.2.0.0
  * License  : ISC (see file LICENSE.txt)
  *
  * NOTE: This code is currently below version 1.0, and therefore is considered
@@ -17,27 +17,266 @@
  */
 
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include <errno.h>
+#include <pthread.h>
+#include <semaphore.h>
+#include <stdatomic.h>
 
 #include "../version.h"
+#include "error.h"
 
-static int g_enable = 1;
+/*
+ * Bounded multi-producer/multi-consumer queue (Vyukov). Every thread
+ * reporting an error is a producer, the logger thread and the exit
+ * handler flushing what is left are the consumers. A cell is free for
+ * the producer of ticket 'pos' when its 'seq' equals 'pos' and holds a
+ * message for the consumer of ticket 'pos' when 'seq' equals 'pos + 1'.
+ */
+struct error_cell {
+    atomic_size_t seq;
+    struct uart_error err;
+};
+
+static atomic_int g_enable = 1;
+static __thread struct uart_error g_last;
+
+static struct error_cell g_queue[ERROR_QUEUE_SIZE];
+static atomic_size_t g_enqueue;
+static atomic_size_t g_dequeue;
+static atomic_ullong g_dropped;
+static sem_t g_pending;
+static pthread_once_t g_once = PTHREAD_ONCE_INIT;
+static int g_started;
+
+static pthread_mutex_t g_log_lock = PTHREAD_MUTEX_INITIALIZER;
+static uart_log_cb g_log_cb;
+static void *g_log_arg;
+
+static int error_push(const struct uart_error *err)
+{
+    struct error_cell *cell;
+    size_t pos;
+    size_t seq;
+
+    pos = atomic_load_explicit(&g_enqueue, memory_order_relaxed);
+
+    while (1) {
+        cell = &g_queue[pos & (ERROR_QUEUE_SIZE - 1)];
+        seq = atomic_load_explicit(&cell->seq, memory_order_acquire);
+
+        if (seq == pos) {
+            if (atomic_compare_exchange_weak_explicit(&g_enqueue, &pos,
+                                                      pos + 1,
+                                                      memory_order_relaxed,
+                                                      memory_order_relaxed))
+                break;
+        } else if (seq < pos) {
+            return -1;
+        } else {
+            pos = atomic_load_explicit(&g_enqueue, memory_order_relaxed);
+        }
+    }
+
+    cell->err = (*err);
+    atomic_store_explicit(&cell->seq, pos + 1, memory_order_release);
+    return 0;
+}
+
+static int error_pop(struct uart_error *err)
+{
+    struct error_cell *cell;
+    size_t pos;
+    size_t seq;
+
+    pos = atomic_load_explicit(&g_dequeue, memory_order_relaxed);
+
+    while (1) {
+        cell = &g_queue[pos & (ERROR_QUEUE_SIZE - 1)];
+        seq = atomic_load_explicit(&cell->seq, memory_order_acquire);
+
+        if (seq == pos + 1) {
+            if (atomic_compare_exchange_weak_explicit(&g_dequeue, &pos,
+                                                      pos + 1,
+                                                      memory_order_relaxed,
+                                                      memory_order_relaxed))
+                break;
+        } else if (seq < pos + 1) {
+            return -1;
+        } else {
+            pos = atomic_load_explicit(&g_dequeue, memory_order_relaxed);
+        }
+    }
+
+    (*err) = cell->err;
+    atomic_store_explicit(&cell->seq, pos + ERROR_QUEUE_SIZE,
+                          memory_order_release);
+    return 0;
+}
+
+static void error_print(const struct uart_error *err)
+{
+    if (err->code == UART_ERR_SYS)
+        fprintf(stderr, "[%s] error: %s (%s)\r\n", LIBUART_NAME, err->msg,
+                strerror(err->sys_errno));
+    else
+        fprintf(stderr, "[%s] error: %s\r\n", LIBUART_NAME, err->msg);
+}
+
+/* must be called with g_log_lock held */
+static void error_deliver(const struct uart_error *err)
+{
+    unsigned long long dropped;
+
+    if (g_log_cb) {
+        g_log_cb(err, g_log_arg);
+        return;
+    }
+
+    dropped = atomic_exchange(&g_dropped, 0);
+
+    if (dropped)
+        fprintf(stderr, "[%s] error: %llu messages dropped\r\n",
+                LIBUART_NAME, dropped);
+
+    error_print(err);
+}
+
+/*
+ * Consumers pop under the lock, so once error_drain() returns in the
+ * exit handler no message is left half-delivered by the logger thread.
+ */
+static void error_drain(void)
+{
+    struct uart_error err;
+
+    pthread_mutex_lock(&g_log_lock);
+
+    while (error_pop(&err) == 0)
+        error_deliver(&err);
+
+    pthread_mutex_unlock(&g_log_lock);
+}
+
+static void *error_thread(void *arg)
+{
+    (void) arg;
+
+    while (1) {
+        while (sem_wait(&g_pending) == -1 && errno == EINTR)
+            ;
+
+        error_drain();
+    }
+
+    return NULL;
+}
+
+static void error_start(void)
+{
+    pthread_attr_t attr;
+    pthread_t thread;
+    size_t i;
+
+    for (i = 0; i < ERROR_QUEUE_SIZE; i++)
+        atomic_init(&g_queue[i].seq, i);
+
+    if (sem_init(&g_pending, 0, 0) == -1)
+        return;
+
+    pthread_attr_init(&attr);
+    pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+
+    if (pthread_create(&thread, &attr, error_thread, NULL) == 0) {
+        atexit(error_drain);
+        g_started = 1;
+    }
+
+    pthread_attr_destroy(&attr);
+}
 
 void error_enable(int enable)
 {
-    g_enable = enable;
+    atomic_store(&g_enable, enable);
 }
 
-void error(const char *err_msg, int detail)
+void error_set_log(uart_log_cb cb, void *arg)
+{
+    pthread_mutex_lock(&g_log_lock);
+    g_log_cb = cb;
+    g_log_arg = arg;
+    pthread_mutex_unlock(&g_log_lock);
+}
+
+/*
+ * Without a logger thread the message is delivered by the caller. The
+ * callback is called without the lock and with a copy of the message, a
+ * libUART function failing inside it reports its error like any other.
+ */
+static void error_direct(const struct uart_error *err)
+{
+    struct uart_error copy = (*err);
+    uart_log_cb cb;
+    void *arg;
+
+    pthread_mutex_lock(&g_log_lock);
+    cb = g_log_cb;
+    arg = g_log_arg;
+
+    if (!cb)
+        error_deliver(&copy);
+
+    pthread_mutex_unlock(&g_log_lock);
+
+    if (cb)
+        cb(&copy, arg);
+}
+
+/*
+ * Record the error for libUART_last_error() and hand it to the logger.
+ * The record is the last failure of the thread, successful calls leave
+ * it alone.
+ * Nothing here blocks: if the queue is full the message is dropped and
+ * only counted.
+ */
+void error_code(int code, const char *err_msg)
 {
-    if (!g_enable)
+    int saved = errno;
+
+    g_last.code = code;
+    g_last.sys_errno = code == UART_ERR_SYS ? saved : 0;
+    g_last.msg = err_msg;
+
+    if (!atomic_load_explicit(&g_enable, memory_order_relaxed))
+        return;
+
+    pthread_once(&g_once, error_start);
+
+    /* no logger thread, fall back to printing directly */
+    if (!g_started) {
+        error_direct(&g_last);
+        errno = saved;
         return;
-    
-    fprintf(stderr, "[%s] error: ", LIBUART_NAME);
-    
-    if (detail)
-        fprintf(stderr, "%s (%s)\r\n", err_msg, strerror(errno));
+    }
+
+    if (error_push(&g_last) == 0)
+        sem_post(&g_pending);
     else
-        fprintf(stderr, "%s\r\n", err_msg);
+        atomic_fetch_add(&g_dropped, 1);
+
+    errno = saved;
+}
+
+void error(const char *err_msg, int detail)
+{
+    error_code(detail ? UART_ERR_SYS : UART_ERR_INVAL, err_msg);
+}
+
+int error_last(struct uart_error *err)
+{
+    if (err)
+        (*err) = g_last;
+
+    return g_last.code;
 }
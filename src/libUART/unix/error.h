@@ -5,9 +5,9 @@
  * Project  : libUART
  * Author   : Copyright (C) 2018-2020 Johannes Krottmayer <krjdev@gmail.com>
  * Created  : 2019-11-20
- * Modified : 
+ * Modified : 2026-10-19
  * Revised  : 
- * Version  : 0.1.0.0
+ * Version  : 0.2.0.0
  * License  : ISC (see file LICENSE.txt)
  *
  * NOTE: This code is currently below version 1.0, and therefore is considered
@@ -19,7 +19,18 @@
 #ifndef LIBUART_UNIX_ERROR_H
 #define LIBUART_UNIX_ERROR_H
 
-void error_enable(int enable);
-void error(const char *err_msg, int detail);
+#include "../libUART.h"
+
+/* keep error() from being interposed by the libc function of the same name */
+#define ERROR_LOCAL         __attribute__((visibility("hidden")))
+
+/* messages waiting for the logger, must be a power of two */
+#define ERROR_QUEUE_SIZE    256
+
+ERROR_LOCAL void error_enable(int enable);
+ERROR_LOCAL void error(const char *err_msg, int detail);
+ERROR_LOCAL void error_code(int code, const char *err_msg);
+ERROR_LOCAL int error_last(struct uart_error *err);
+ERROR_LOCAL void error_set_log(uart_log_cb cb, void *arg);
 
 #endif
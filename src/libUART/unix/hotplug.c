@@ -0,0 +1,330 @@
+/**
+ *
+ * File Name: unix/hotplug.c
+ * Title    : UNIX UART hotplug monitoring
+ * Project  : libUART
+ * Author   : Copyright (C) 2018-2020 Johannes Krottmayer <krjdev@gmail.com>
+ * Created  : 2026-10-19
+ * Modified :
+ * Revised  :
+ * Version  : 0.1.0.0
+ * License  : ISC (see file LICENSE.txt)
+ *
+ * NOTE: This code is currently below version 1.0, and therefore is considered
+ * to be lacking in some functionality or documentation, or may not be fully
+ * tested. Nonetheless, you can expect most functions to work.
+ *
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <limits.h>
+#include <pthread.h>
+#include <termios.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <linux/netlink.h>
+
+#include "error.h"
+#include "hotplug.h"
+
+/* udev prefixes its messages with this header */
+struct hotplug_udev_hdr {
+    char prefix[8];             /* "libudev" */
+    unsigned int magic;
+    unsigned int header_size;
+    unsigned int properties_off;
+    unsigned int properties_len;
+};
+
+struct hotplug_event {
+    const char *action;
+    const char *subsystem;
+    const char *devlinks;
+    char devname[DEV_NAME_LEN];
+};
+
+static pthread_once_t g_once = PTHREAD_ONCE_INIT;
+static pthread_mutex_t g_lock = PTHREAD_MUTEX_INITIALIZER;
+static struct hotplug *g_list;
+static int g_sock = -1;
+static int g_errno;
+
+/* both the kernel and udev send NUL separated KEY=VALUE properties */
+static int hotplug_parse(char *buf, int len, struct hotplug_event *ev)
+{
+    struct hotplug_udev_hdr hdr;
+    const char *name = NULL;
+    char *kv;
+    int off;
+
+    memset(ev, 0, sizeof(*ev));
+    buf[len] = '\0';
+
+    if ((size_t) len >= sizeof(hdr) && memcmp(buf, "libudev", 8) == 0) {
+        memcpy(&hdr, buf, sizeof(hdr));
+
+        if (hdr.properties_off >= (unsigned int) len)
+            return -1;
+
+        off = hdr.properties_off;
+    } else {
+        /* "ACTION@DEVPATH" comes first */
+        if (!strchr(buf, '@'))
+            return -1;
+
+        off = strlen(buf) + 1;
+    }
+
+    for (; off < len; off += strlen(kv) + 1) {
+        kv = buf + off;
+
+        if (strncmp(kv, "ACTION=", 7) == 0)
+            ev->action = kv + 7;
+        else if (strncmp(kv, "SUBSYSTEM=", 10) == 0)
+            ev->subsystem = kv + 10;
+        else if (strncmp(kv, "DEVNAME=", 8) == 0)
+            name = kv + 8;
+        else if (strncmp(kv, "DEVLINKS=", 9) == 0)
+            ev->devlinks = kv + 9;
+    }
+
+    if (!ev->action || !ev->subsystem || !name ||
+        strcmp(ev->subsystem, "tty") != 0)
+        return -1;
+
+    /* the kernel names the node relative to /dev */
+    if (name[0] != '/') {
+        if (strlen("/dev/") + strlen(name) >= sizeof(ev->devname))
+            return -1;
+
+        strcpy(ev->devname, "/dev/");
+        strcat(ev->devname, name);
+    } else {
+        if (strlen(name) >= sizeof(ev->devname))
+            return -1;
+
+        strcpy(ev->devname, name);
+    }
+
+    return 0;
+}
+
+/* remember the node behind a symbolic link, e.g. /dev/serial/by-id/... */
+static void hotplug_node(struct hotplug *h)
+{
+    char path[PATH_MAX];
+
+    if (realpath(h->uart->dev, path) && strlen(path) < sizeof(h->node))
+        strcpy(h->node, path);
+    else
+        strcpy(h->node, h->uart->dev);
+}
+
+static int hotplug_match(struct hotplug *h, const struct hotplug_event *ev)
+{
+    char path[PATH_MAX];
+    const char *dev = h->uart->dev;
+    const char *p;
+    size_t len = strlen(dev);
+
+    if (strcmp(ev->devname, h->node) == 0 || strcmp(ev->devname, dev) == 0)
+        return 1;
+
+    /* udev lists the symbolic links it created for the node */
+    for (p = ev->devlinks; p && (p = strstr(p, dev)); p += len) {
+        if ((p == ev->devlinks || p[-1] == ' ') &&
+            (p[len] == ' ' || p[len] == '\0'))
+            return 1;
+    }
+
+    return realpath(dev, path) && strcmp(path, ev->devname) == 0;
+}
+
+/* must be called with g_lock held */
+static void hotplug_reopen(struct hotplug *h)
+{
+    /* udev sends another event once the node is ready */
+    if (uart_reopen(h->uart) == -1)
+        return;
+
+    h->gone = 0;
+    hotplug_node(h);
+
+    if (h->cb)
+        h->cb(h->uart, UART_HOTPLUG_REOPENED, h->arg);
+}
+
+static void hotplug_handle(const struct hotplug_event *ev)
+{
+    struct termios options;
+    struct hotplug *h;
+    int add;
+
+    if (strcmp(ev->action, "add") == 0)
+        add = 1;
+    else if (strcmp(ev->action, "remove") == 0)
+        add = 0;
+    else
+        return;
+
+    pthread_mutex_lock(&g_lock);
+
+    for (h = g_list; h; h = h->next) {
+        if (!add && !h->gone && strcmp(ev->devname, h->node) == 0) {
+            h->gone = 1;
+
+            if (h->cb)
+                h->cb(h->uart, UART_HOTPLUG_REMOVED, h->arg);
+        } else if (add && hotplug_match(h, ev)) {
+            /* the remove event may have been lost, check the old device */
+            if (h->gone || tcgetattr(h->uart->fd, &options) == -1)
+                hotplug_reopen(h);
+        }
+    }
+
+    pthread_mutex_unlock(&g_lock);
+}
+
+/* the socket buffer overflowed, events were lost */
+static void hotplug_rescan(void)
+{
+    struct hotplug *h;
+
+    pthread_mutex_lock(&g_lock);
+
+    for (h = g_list; h; h = h->next) {
+        if (h->gone && access(h->uart->dev, R_OK | W_OK) == 0)
+            hotplug_reopen(h);
+    }
+
+    pthread_mutex_unlock(&g_lock);
+}
+
+static void *hotplug_thread(void *arg)
+{
+    char buf[HOTPLUG_MSG_SIZE + 1];
+    struct hotplug_event ev;
+    ssize_t len;
+
+    (void) arg;
+
+    while (1) {
+        len = recv(g_sock, buf, HOTPLUG_MSG_SIZE, 0);
+
+        if (len == -1) {
+            if (errno == ENOBUFS) {
+                hotplug_rescan();
+                continue;
+            }
+
+            if (errno == EINTR)
+                continue;
+
+            error("recv() failed", 1);
+            break;
+        }
+
+        if (hotplug_parse(buf, len, &ev) == 0)
+            hotplug_handle(&ev);
+    }
+
+    return NULL;
+}
+
+static void hotplug_start(void)
+{
+    struct sockaddr_nl addr;
+    pthread_attr_t attr;
+    pthread_t thread;
+    int size = HOTPLUG_RCVBUF;
+    int sock;
+    int ret;
+
+    sock = socket(AF_NETLINK, SOCK_DGRAM | SOCK_CLOEXEC,
+                  NETLINK_KOBJECT_UEVENT);
+
+    if (sock == -1) {
+        g_errno = errno;
+        return;
+    }
+
+    setsockopt(sock, SOL_SOCKET, SO_RCVBUF, &size, sizeof(size));
+    memset(&addr, 0, sizeof(addr));
+    addr.nl_family = AF_NETLINK;
+    addr.nl_groups = HOTPLUG_GROUP_KERNEL | HOTPLUG_GROUP_UDEV;
+
+    if (bind(sock, (struct sockaddr *) &addr, sizeof(addr)) == -1) {
+        g_errno = errno;
+        close(sock);
+        return;
+    }
+
+    g_sock = sock;
+    pthread_attr_init(&attr);
+    pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+    ret = pthread_create(&thread, &attr, hotplug_thread, NULL);
+    pthread_attr_destroy(&attr);
+
+    if (ret != 0) {
+        g_errno = ret;
+        close(sock);
+        g_sock = -1;
+    }
+}
+
+int hotplug_watch(struct _uart *uart, uart_hotplug_cb cb, void *arg)
+{
+    struct hotplug *h;
+
+    pthread_once(&g_once, hotplug_start);
+
+    if (g_sock == -1) {
+        errno = g_errno;
+        error("hotplug monitor not available", 1);
+        return -1;
+    }
+
+    pthread_mutex_lock(&g_lock);
+    h = uart->hp;
+
+    if (!h) {
+        h = (struct hotplug *) calloc(1, sizeof(*h));
+
+        if (!h) {
+            pthread_mutex_unlock(&g_lock);
+            error("calloc() failed", 1);
+            return -1;
+        }
+
+        h->uart = uart;
+        hotplug_node(h);
+        h->next = g_list;
+        g_list = h;
+        uart->hp = h;
+    }
+
+    h->cb = cb;
+    h->arg = arg;
+    pthread_mutex_unlock(&g_lock);
+    return 0;
+}
+
+void hotplug_unwatch(struct _uart *uart)
+{
+    struct hotplug **pp;
+
+    pthread_mutex_lock(&g_lock);
+
+    for (pp = &g_list; (*pp); pp = &(*pp)->next) {
+        if ((*pp) == uart->hp) {
+            (*pp) = uart->hp->next;
+            break;
+        }
+    }
+
+    free(uart->hp);
+    uart->hp = NULL;
+    pthread_mutex_unlock(&g_lock);
+}
@@ -0,0 +1,45 @@
+/**
+ *
+ * File Name: unix/hotplug.h
+ * Title    : UNIX UART hotplug monitoring
+ * Project  : libUART
+ * Author   : Copyright (C) 2018-2020 Johannes Krottmayer <krjdev@gmail.com>
+ * Created  : 2026-10-19
+ * Modified :
+ * Revised  :
+ * Version  : 0.1.0.0
+ * License  : ISC (see file LICENSE.txt)
+ *
+ * NOTE: This code is currently below version 1.0, and therefore is considered
+ * to be lacking in some functionality or documentation, or may not be fully
+ * tested. Nonetheless, you can expect most functions to work.
+ *
+ */
+
+#ifndef LIBUART_UNIX_HOTPLUG_H
+#define LIBUART_UNIX_HOTPLUG_H
+
+#include "../libUART.h"
+#include "uart.h"
+
+/* multicast groups of the kernel and of udev */
+#define HOTPLUG_GROUP_KERNEL    1
+#define HOTPLUG_GROUP_UDEV      2
+#define HOTPLUG_MSG_SIZE        8192
+/* socket buffer large enough for a hub dropping all of its ports */
+#define HOTPLUG_RCVBUF          (1024 * 1024)
+
+/* a watched port */
+struct hotplug {
+    struct _uart *uart;
+    uart_hotplug_cb cb;
+    void *arg;
+    char node[DEV_NAME_LEN];    /* device node behind uart->dev */
+    int gone;
+    struct hotplug *next;
+};
+
+extern int hotplug_watch(struct _uart *uart, uart_hotplug_cb cb, void *arg);
+extern void hotplug_unwatch(struct _uart *uart);
+
+#endif
@@ -0,0 +1,121 @@
+/**
+ *
+ * File Name: unix/icount.c
+ * Title    : UNIX UART line error counters
+ * Project  : libUART
+ * Author   : Copyright (C) 2018-2020 Johannes Krottmayer <krjdev@gmail.com>
+ * Created  : 2026-10-19
+ * Modified :
+ * Revised  :
+ * Version  : 0.1.0.0
+ * License  : ISC (see file LICENSE.txt)
+ *
+ * NOTE: This code is currently below version 1.0, and therefore is considered
+ * to be lacking in some functionality or documentation, or may not be fully
+ * tested. Nonetheless, you can expect most functions to work.
+ *
+ */
+
+#include <string.h>
+#include <sys/ioctl.h>
+
+#ifdef __linux__
+#include <linux/serial.h>
+#endif
+
+#include "error.h"
+#include "uart.h"
+#include "icount.h"
+
+#ifdef __linux__
+static int icount_read(struct _uart *uart, struct uart_icount *now)
+{
+    struct serial_icounter_struct ic;
+
+    if (ioctl(uart->fd, TIOCGICOUNT, &ic) == -1)
+        return -1;
+
+    now->rx = ic.rx;
+    now->tx = ic.tx;
+    now->frame = ic.frame;
+    now->parity = ic.parity;
+    now->overrun = ic.overrun;
+    now->brk = ic.brk;
+    now->buf_overrun = ic.buf_overrun;
+    return 0;
+}
+#else
+static int icount_read(struct _uart *uart, struct uart_icount *now)
+{
+    (void) uart;
+    (void) now;
+    return -1;
+}
+#endif
+
+/* take the baseline for the first delta, devices without counters are fine */
+void icount_init(struct _uart *uart)
+{
+    if (icount_read(uart, &uart->icount.last) == -1)
+        memset(&uart->icount.last, 0, sizeof(uart->icount.last));
+}
+
+/* a zero threshold disables the check of that counter */
+static int icount_exceeds(const struct uart_icount *d,
+                          const struct uart_icount *t)
+{
+    return (t->rx && d->rx >= t->rx) ||
+           (t->tx && d->tx >= t->tx) ||
+           (t->frame && d->frame >= t->frame) ||
+           (t->parity && d->parity >= t->parity) ||
+           (t->overrun && d->overrun >= t->overrun) ||
+           (t->brk && d->brk >= t->brk) ||
+           (t->buf_overrun && d->buf_overrun >= t->buf_overrun);
+}
+
+int icount_get(struct _uart *uart, struct uart_icount *total,
+               struct uart_icount *delta)
+{
+    struct uart_icount *last = &uart->icount.last;
+    struct uart_icount now;
+    struct uart_icount d;
+
+    if (icount_read(uart, &now) == -1) {
+        error("ioctl() failed", 1);
+        return -1;
+    }
+
+    /* unsigned arithmetic keeps the deltas right across counter wraps */
+    d.rx = now.rx - last->rx;
+    d.tx = now.tx - last->tx;
+    d.frame = now.frame - last->frame;
+    d.parity = now.parity - last->parity;
+    d.overrun = now.overrun - last->overrun;
+    d.brk = now.brk - last->brk;
+    d.buf_overrun = now.buf_overrun - last->buf_overrun;
+    (*last) = now;
+
+    if (total)
+        (*total) = now;
+
+    if (delta)
+        (*delta) = d;
+
+    if (uart->icount.cb && icount_exceeds(&d, &uart->icount.threshold))
+        uart->icount.cb(uart, &d, uart->icount.arg);
+
+    return 0;
+}
+
+void icount_set_threshold(struct _uart *uart,
+                          const struct uart_icount *threshold,
+                          uart_icount_cb cb, void *arg)
+{
+    if (threshold)
+        uart->icount.threshold = (*threshold);
+    else
+        memset(&uart->icount.threshold, 0, sizeof(uart->icount.threshold));
+
+    uart->icount.cb = cb;
+    uart->icount.arg = arg;
+}
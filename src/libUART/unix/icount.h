@@ -0,0 +1,40 @@
+/**
+ *
+ * File Name: unix/icount.h
+ * Title    : UNIX UART line error counters
+ * Project  : libUART
+ * Author   : Copyright (C) 2018-2020 Johannes Krottmayer <krjdev@gmail.com>
+ * Created  : 2026-10-19
+ * Modified :
+ * Revised  :
+ * Version  : 0.1.0.0
+ * License  : ISC (see file LICENSE.txt)
+ *
+ * NOTE: This code is currently below version 1.0, and therefore is considered
+ * to be lacking in some functionality or documentation, or may not be fully
+ * tested. Nonetheless, you can expect most functions to work.
+ *
+ */
+
+#ifndef LIBUART_UNIX_ICOUNT_H
+#define LIBUART_UNIX_ICOUNT_H
+
+#include "../libUART.h"
+
+struct _uart;
+
+struct icount {
+    struct uart_icount last;
+    struct uart_icount threshold;
+    uart_icount_cb cb;
+    void *arg;
+};
+
+extern void icount_init(struct _uart *uart);
+extern int icount_get(struct _uart *uart, struct uart_icount *total,
+                      struct uart_icount *delta);
+extern void icount_set_threshold(struct _uart *uart,
+                                 const struct uart_icount *threshold,
+                                 uart_icount_cb cb, void *arg);
+
+#endif
@@ -0,0 +1,217 @@
+/**
+ *
+ * File Name: unix/latency.c
+ * Title    : UNIX UART round-trip latency histograms
+ * Project  : libUART
+ * Author   : Copyright (C) 2018-2020 Johannes Krottmayer <krjdev@gmail.com>
+ * Created  : 2026-10-19
+ * Modified :
+ * Revised  :
+ * Version  : 0.1.0.0
+ * License  : ISC (see file LICENSE.txt)
+ *
+ * NOTE: This code is currently below version 1.0, and therefore is considered
+ * to be lacking in some functionality or documentation, or may not be fully
+ * tested. Nonetheless, you can expect most functions to work.
+ *
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "error.h"
+#include "uart.h"
+#include "stats.h"
+#include "latency.h"
+
+#define SUB_COUNT       (1 << UART_HIST_SUB_BITS)
+
+/*
+ * Log-linear bucket index: values below SUB_COUNT get a bucket each,
+ * above that every power of two is split into SUB_COUNT buckets, so the
+ * relative error stays below 1 / SUB_COUNT over the whole range.
+ */
+static int hist_index(long long value)
+{
+    int msb;
+    int idx;
+
+    if (value < SUB_COUNT)
+        return value < 0 ? 0 : (int) value;
+
+    msb = 63 - __builtin_clzll((unsigned long long) value);
+    idx = (msb - UART_HIST_SUB_BITS + 1) * SUB_COUNT +
+          (int) ((value >> (msb - UART_HIST_SUB_BITS)) - SUB_COUNT);
+
+    if (idx >= UART_HIST_BUCKETS)
+        return UART_HIST_BUCKETS - 1;
+
+    return idx;
+}
+
+/* highest value that falls into bucket 'idx' */
+static long long hist_value(int idx)
+{
+    int shift;
+
+    if (idx < SUB_COUNT)
+        return idx;
+
+    shift = idx / SUB_COUNT - 1;
+    return ((long long) (SUB_COUNT + idx % SUB_COUNT + 1) << shift) - 1;
+}
+
+void hist_record(struct uart_hist *hist, long long value)
+{
+    if (hist->count == 0 || value < hist->min)
+        hist->min = value;
+
+    if (value > hist->max)
+        hist->max = value;
+
+    hist->count++;
+    hist->bucket[hist_index(value)]++;
+}
+
+void hist_merge(struct uart_hist *dst, const struct uart_hist *src)
+{
+    int i;
+
+    if (src->count == 0)
+        return;
+
+    if (dst->count == 0 || src->min < dst->min)
+        dst->min = src->min;
+
+    if (src->max > dst->max)
+        dst->max = src->max;
+
+    dst->count += src->count;
+
+    for (i = 0; i < UART_HIST_BUCKETS; i++)
+        dst->bucket[i] += src->bucket[i];
+}
+
+long long hist_percentile(const struct uart_hist *hist, double p)
+{
+    unsigned long long target;
+    unsigned long long sum = 0;
+    long long value;
+    int i;
+
+    if (hist->count == 0)
+        return 0;
+
+    target = (unsigned long long) (p / 100.0 * hist->count + 0.5);
+
+    if (target < 1)
+        target = 1;
+
+    for (i = 0; i < UART_HIST_BUCKETS; i++) {
+        sum += hist->bucket[i];
+
+        if (sum >= target)
+            break;
+    }
+
+    value = hist_value(i);
+
+    if (value > hist->max)
+        return hist->max;
+
+    if (value < hist->min)
+        return hist->min;
+
+    return value;
+}
+
+int lat_create(struct _uart *uart)
+{
+    struct latency *lat;
+
+    lat = (struct latency *) calloc(1, sizeof(*lat));
+
+    if (!lat) {
+        error("calloc() failed", 1);
+        return -1;
+    }
+
+    atomic_init(&lat->cls, -1);
+    atomic_init(&lat->tx_ns, 0);
+    atomic_init(&lat->rx_ns, 0);
+    uart->lat = lat;
+    return 0;
+}
+
+void lat_destroy(struct _uart *uart)
+{
+    free(uart->lat);
+    uart->lat = NULL;
+}
+
+void lat_begin(struct _uart *uart, int cls)
+{
+    struct latency *lat = uart->lat;
+
+    atomic_store_explicit(&lat->tx_ns, 0, memory_order_relaxed);
+    atomic_store_explicit(&lat->rx_ns, 0, memory_order_relaxed);
+    atomic_store_explicit(&lat->cls, cls, memory_order_release);
+}
+
+int lat_end(struct _uart *uart)
+{
+    struct latency *lat = uart->lat;
+    long long tx_ns;
+    int cls;
+
+    cls = atomic_exchange_explicit(&lat->cls, -1, memory_order_acq_rel);
+    tx_ns = atomic_load_explicit(&lat->tx_ns, memory_order_relaxed);
+
+    if (cls < 0 || tx_ns == 0) {
+        error_code(UART_ERR_STATE, "no round trip in progress");
+        return -1;
+    }
+
+    hist_record(&lat->hist[cls][UART_LAT_FINAL],
+                (stats_now_ns() - tx_ns) / 1000);
+    return 0;
+}
+
+/* the last byte of the command has been handed to the driver */
+void lat_tx_done(struct _uart *uart)
+{
+    struct latency *lat = uart->lat;
+
+    if (atomic_load_explicit(&lat->cls, memory_order_acquire) < 0 ||
+        atomic_load_explicit(&lat->rx_ns, memory_order_relaxed) != 0)
+        return;
+
+    atomic_store_explicit(&lat->tx_ns, stats_now_ns(), memory_order_relaxed);
+}
+
+void lat_rx(struct _uart *uart)
+{
+    struct latency *lat = uart->lat;
+    long long tx_ns;
+    long long now;
+    int cls;
+
+    cls = atomic_load_explicit(&lat->cls, memory_order_acquire);
+
+    if (cls < 0 || atomic_load_explicit(&lat->rx_ns, memory_order_relaxed))
+        return;
+
+    tx_ns = atomic_load_explicit(&lat->tx_ns, memory_order_relaxed);
+
+    if (tx_ns == 0)
+        return;
+
+    now = stats_now_ns();
+    atomic_store_explicit(&lat->rx_ns, now, memory_order_relaxed);
+    hist_record(&lat->hist[cls][UART_LAT_FIRST_BYTE], (now - tx_ns) / 1000);
+}
+
+void lat_reset(struct _uart *uart)
+{
+    memset(uart->lat->hist, 0, sizeof(uart->lat->hist));
+}
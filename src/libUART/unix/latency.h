@@ -0,0 +1,51 @@
+/**
+ *
+ * File Name: unix/latency.h
+ * Title    : UNIX UART round-trip latency histograms
+ * Project  : libUART
+ * Author   : Copyright (C) 2018-2020 Johannes Krottmayer <krjdev@gmail.com>
+ * Created  : 2026-10-19
+ * Modified :
+ * Revised  :
+ * Version  : 0.1.0.0
+ * License  : ISC (see file LICENSE.txt)
+ *
+ * NOTE: This code is currently below version 1.0, and therefore is considered
+ * to be lacking in some functionality or documentation, or may not be fully
+ * tested. Nonetheless, you can expect most functions to work.
+ *
+ */
+
+#ifndef LIBUART_UNIX_LATENCY_H
+#define LIBUART_UNIX_LATENCY_H
+
+#include <stdatomic.h>
+
+#include "../libUART.h"
+
+struct _uart;
+
+/*
+ * Round trip in flight: 'cls' is the command class armed by lat_begin()
+ * (-1 if none), 'tx_ns' the time the last byte of the command was
+ * written and 'rx_ns' the time the first byte of the answer arrived.
+ */
+struct latency {
+    atomic_int cls;
+    atomic_llong tx_ns;
+    atomic_llong rx_ns;
+    struct uart_hist hist[UART_LAT_CLASSES][UART_LAT_KINDS];
+};
+
+extern int lat_create(struct _uart *uart);
+extern void lat_destroy(struct _uart *uart);
+extern void lat_begin(struct _uart *uart, int cls);
+extern int lat_end(struct _uart *uart);
+extern void lat_tx_done(struct _uart *uart);
+extern void lat_rx(struct _uart *uart);
+extern void lat_reset(struct _uart *uart);
+extern void hist_record(struct uart_hist *hist, long long value);
+extern void hist_merge(struct uart_hist *dst, const struct uart_hist *src);
+extern long long hist_percentile(const struct uart_hist *hist, double p);
+
+#endif
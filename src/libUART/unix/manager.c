@@ -0,0 +1,845 @@
+/**
+ *
+ * File Name: unix/manager.c
+ * Title    : UNIX UART port manager
+ * Project  : libUART
+ * Author   : Copyright (C) 2018-2020 Johannes Krottmayer <krjdev@gmail.com>
+ * Created  : 2026-10-19
+ * Modified :
+ * Revised  :
+ * Version  : 0.1.0.0
+ * License  : ISC (see file LICENSE.txt)
+ *
+ * NOTE: This code is currently below version 1.0, and therefore is considered
+ * to be lacking in some functionality or documentation, or may not be fully
+ * tested. Nonetheless, you can expect most functions to work.
+ *
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <stdint.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/uio.h>
+
+#include "error.h"
+#include "stats.h"
+#include "uart.h"
+#include "manager.h"
+#include "reconnect.h"
+
+#define SLAB_DATA(s)        ((char *) ((s) + 1))
+
+static struct mgr_slab *mgr_slab_get(struct _uart_mgr *mgr)
+{
+    struct mgr_slab *s = mgr->free;
+
+    if (!s)
+        return NULL;
+
+    mgr->free = s->next;
+    mgr->free_slabs--;
+    s->next = NULL;
+    s->len = 0;
+    s->off = 0;
+    s->rx_ns = 0;
+    s->first_ns = 0;
+    s->mark = 0;
+    s->mark_rx_ns = 0;
+    s->mark_first_ns = 0;
+    return s;
+}
+
+static void mgr_slab_put(struct _uart_mgr *mgr, struct mgr_slab *s)
+{
+    s->next = mgr->free;
+    mgr->free = s;
+    mgr->free_slabs++;
+}
+
+static void mgr_slab_put_list(struct _uart_mgr *mgr, struct mgr_slab *s)
+{
+    struct mgr_slab *next;
+
+    for (; s; s = next) {
+        next = s->next;
+        mgr_slab_put(mgr, s);
+    }
+}
+
+/* copy data to the end of a slab list, returns the number of bytes that fit */
+static int mgr_append(struct _uart_mgr *mgr, struct mgr_slab **head,
+                      struct mgr_slab **tail, const char *data, int len)
+{
+    struct mgr_slab *s;
+    int done = 0;
+    int n;
+
+    while (done < len) {
+        s = (*tail);
+
+        if (!s || s->len == mgr->slab_size) {
+            s = mgr_slab_get(mgr);
+
+            if (!s)
+                break;
+
+            if (*tail)
+                (*tail)->next = s;
+            else
+                (*head) = s;
+
+            (*tail) = s;
+        }
+
+        n = mgr->slab_size - s->len;
+
+        if (n > len - done)
+            n = len - done;
+
+        memcpy(SLAB_DATA(s) + s->len, data + done, n);
+        s->len += n;
+        done += n;
+    }
+
+    return done;
+}
+
+/* bring the armed epoll events in line with the port state */
+static int mgr_arm(struct mgr_port *p)
+{
+    struct epoll_event ev;
+    unsigned int events = 0;
+
+    if (p->hung)
+        return 0;
+
+    if (!p->blocked)
+        events |= EPOLLIN;
+
+    if (p->tx_head)
+        events |= EPOLLOUT;
+
+    if (events == p->events)
+        return 0;
+
+    ev.events = events;
+    ev.data.ptr = p;
+
+    if (epoll_ctl(p->mgr->epfd, EPOLL_CTL_MOD, p->uart->fd, &ev) == -1) {
+        error("epoll_ctl() failed", 1);
+        return -1;
+    }
+
+    p->events = events;
+    return 0;
+}
+
+/* the pool ran dry, stop polling the port until slabs come back */
+static void mgr_block(struct mgr_port *p)
+{
+    if (p->blocked)
+        return;
+
+    p->blocked = 1;
+    p->mgr->blocked++;
+    mgr_arm(p);
+}
+
+static void mgr_unblock(struct _uart_mgr *mgr)
+{
+    struct mgr_port *p;
+
+    if (!mgr->blocked || !mgr->free)
+        return;
+
+    for (p = mgr->ports; p; p = p->next) {
+        if (p->blocked) {
+            p->blocked = 0;
+            mgr_arm(p);
+        }
+    }
+
+    mgr->blocked = 0;
+}
+
+/* the device is gone, stop polling it and let the reader see the error */
+static void mgr_hangup(struct mgr_port *p)
+{
+    if (p->hung)
+        return;
+
+    epoll_ctl(p->mgr->epfd, EPOLL_CTL_DEL, p->uart->fd, NULL);
+    p->hung = 1;
+    p->events = 0;
+
+    if (p->blocked) {
+        p->blocked = 0;
+        p->mgr->blocked--;
+    }
+
+    /* mgr_resume() polls the port again after the reopen */
+    if (p->uart->rc)
+        reconnect_lost(p->uart);
+}
+
+/*
+ * Read at most the byte budget of the port into slabs. Everything read
+ * for one epoll wakeup at 'now' is one batch, its bytes are taken to have
+ * arrived back to back, the last one just before the wakeup.
+ */
+static int mgr_read(struct mgr_port *p, long long now)
+{
+    struct _uart_mgr *mgr = p->mgr;
+    struct mgr_slab *start = NULL;
+    struct mgr_slab *cont = NULL;
+    struct mgr_slab *s;
+    long long char_ns;
+    long long arrival;
+    int total = 0;
+    int fresh;
+    int ret = 0;
+    int n;
+
+    while (total < mgr->budget) {
+        s = p->rx_tail;
+        fresh = !s || s->len == mgr->slab_size;
+
+        if (fresh && !(s = mgr_slab_get(mgr))) {
+            mgr_block(p);
+            break;
+        }
+
+        n = mgr->slab_size - s->len;
+
+        if (n > mgr->budget - total)
+            n = mgr->budget - total;
+
+        ret = uart_recv(p->uart, SLAB_DATA(s) + s->len, n);
+
+        if (ret <= 0) {
+            if (fresh)
+                mgr_slab_put(mgr, s);
+
+            break;
+        }
+
+        if (fresh) {
+            if (p->rx_tail)
+                p->rx_tail->next = s;
+            else
+                p->rx_head = s;
+
+            p->rx_tail = s;
+
+            /* offset in the batch until the batch size is known */
+            s->first_ns = total;
+
+            if (!start)
+                start = s;
+        } else if (total == 0) {
+            /* the batch continues the data of an earlier wakeup */
+            s->mark = s->len;
+            cont = s;
+        }
+
+        s->len += ret;
+        total += ret;
+
+        if (ret < n)
+            break;
+    }
+
+    char_ns = uart_char_ns(p->uart);
+    arrival = now - (total - 1) * char_ns;
+
+    if (cont) {
+        cont->mark_rx_ns = now;
+        cont->mark_first_ns = arrival;
+    }
+
+    for (s = start; s; s = s->next) {
+        s->rx_ns = now;
+        s->first_ns = arrival + s->first_ns * char_ns;
+        s->mark_rx_ns = now;
+        s->mark_first_ns = s->first_ns;
+    }
+
+    mgr->rx_bytes += total;
+    return ret == -1 ? -1 : total;
+}
+
+/*
+ * A slab may hold the data of several wakeups, the times of the first
+ * and the latest one are kept. Bytes of the wakeups in between get the
+ * latest wakeup and an arrival extrapolated from the first one.
+ */
+static void mgr_rx_ts(struct mgr_slab *s, struct uart_rx_ts *ts,
+                      long long char_ns)
+{
+    if (s->off >= s->mark) {
+        ts->rx_ns = s->mark_rx_ns;
+        ts->first_ns = s->mark_first_ns + (s->off - s->mark) * char_ns;
+        return;
+    }
+
+    ts->rx_ns = s->rx_ns;
+    ts->first_ns = s->first_ns + s->off * char_ns;
+
+    if (ts->first_ns > s->rx_ns) {
+        ts->rx_ns = s->mark_rx_ns;
+
+        if (ts->first_ns > s->mark_first_ns)
+            ts->first_ns = s->mark_first_ns;
+    }
+}
+
+static int mgr_write(struct mgr_port *p)
+{
+    struct _uart_mgr *mgr = p->mgr;
+    struct iovec iov[MGR_BATCH];
+    struct mgr_slab *s;
+    int cnt;
+    int ret;
+    int n;
+
+    while (p->tx_head) {
+        cnt = 0;
+
+        for (s = p->tx_head; s && cnt < MGR_BATCH; s = s->next) {
+            iov[cnt].iov_base = SLAB_DATA(s) + s->off;
+            iov[cnt].iov_len = s->len - s->off;
+            cnt++;
+        }
+
+        ret = uart_sendv(p->uart, iov, cnt);
+
+        if (ret == -1)
+            return -1;
+
+        /* kernel buffer full, wait for EPOLLOUT */
+        if (ret == 0)
+            break;
+
+        p->tx_pending -= ret;
+        mgr->tx_bytes += ret;
+
+        while (ret > 0) {
+            s = p->tx_head;
+            n = s->len - s->off;
+
+            if (ret < n) {
+                s->off += ret;
+                break;
+            }
+
+            ret -= n;
+            p->tx_head = s->next;
+            mgr_slab_put(mgr, s);
+        }
+
+        if (!p->tx_head)
+            p->tx_tail = NULL;
+    }
+
+    mgr_unblock(mgr);
+    return mgr_arm(p);
+}
+
+/* free ports removed since the last poll, called with the lock held */
+static void mgr_reap(struct _uart_mgr *mgr)
+{
+    struct mgr_port *p;
+
+    while ((p = mgr->dead)) {
+        mgr->dead = p->next;
+        free(p);
+    }
+}
+
+static void mgr_link(struct _uart_mgr *mgr, struct mgr_port *p)
+{
+    p->prev = NULL;
+    p->next = mgr->ports;
+
+    if (mgr->ports)
+        mgr->ports->prev = p;
+
+    mgr->ports = p;
+    mgr->nports++;
+    p->uart->mgr = p;
+}
+
+/* take a port out of its manager, called with the lock held */
+static void mgr_detach(struct mgr_port *p)
+{
+    struct _uart_mgr *mgr = p->mgr;
+
+    mgr_hangup(p);
+    mgr_slab_put_list(mgr, p->rx_head);
+    mgr_slab_put_list(mgr, p->tx_head);
+
+    if (p->prev)
+        p->prev->next = p->next;
+    else
+        mgr->ports = p->next;
+
+    if (p->next)
+        p->next->prev = p->prev;
+
+    mgr->nports--;
+    p->uart = NULL;
+    p->next = mgr->dead;
+    mgr->dead = p;
+    mgr_unblock(mgr);
+}
+
+struct _uart_mgr *mgr_create(int slab_size, int slabs, int budget)
+{
+    struct _uart_mgr *mgr;
+    struct epoll_event ev;
+    struct mgr_slab *s;
+    int ret;
+    int i;
+
+    mgr = (struct _uart_mgr *) calloc(1, sizeof(*mgr));
+
+    if (!mgr) {
+        error("calloc() failed", 1);
+        return NULL;
+    }
+
+    mgr->slab_size = slab_size;
+    mgr->budget = budget;
+    mgr->stride = (sizeof(struct mgr_slab) + slab_size + CACHE_LINE_SIZE - 1) &
+                  ~((size_t) CACHE_LINE_SIZE - 1);
+    ret = posix_memalign((void **) &mgr->pool, CACHE_LINE_SIZE,
+                         mgr->stride * slabs);
+
+    if (ret != 0) {
+        errno = ret;
+        error("posix_memalign() failed", 1);
+        free(mgr);
+        return NULL;
+    }
+
+    /* hand out the slabs in address order */
+    for (i = slabs - 1; i >= 0; i--) {
+        s = (struct mgr_slab *) (mgr->pool + (size_t) i * mgr->stride);
+        mgr_slab_put(mgr, s);
+    }
+
+    mgr->epfd = epoll_create1(EPOLL_CLOEXEC);
+
+    if (mgr->epfd == -1) {
+        error("epoll_create1() failed", 1);
+        free(mgr->pool);
+        free(mgr);
+        return NULL;
+    }
+
+    mgr->wake_fd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    ev.events = EPOLLIN;
+    ev.data.ptr = NULL;
+
+    if (mgr->wake_fd == -1 ||
+        epoll_ctl(mgr->epfd, EPOLL_CTL_ADD, mgr->wake_fd, &ev) == -1) {
+        error("eventfd() failed", 1);
+
+        if (mgr->wake_fd != -1)
+            close(mgr->wake_fd);
+
+        close(mgr->epfd);
+        free(mgr->pool);
+        free(mgr);
+        return NULL;
+    }
+
+    pthread_mutex_init(&mgr->lock, NULL);
+    return mgr;
+}
+
+void mgr_destroy(struct _uart_mgr *mgr)
+{
+    struct _uart *uart;
+
+    while (1) {
+        pthread_mutex_lock(&mgr->lock);
+        uart = mgr->ports ? mgr->ports->uart : NULL;
+        pthread_mutex_unlock(&mgr->lock);
+
+        if (!uart)
+            break;
+
+        uart_close(uart);
+    }
+
+    mgr_reap(mgr);
+    close(mgr->wake_fd);
+    close(mgr->epfd);
+    pthread_mutex_destroy(&mgr->lock);
+    free(mgr->pool);
+    free(mgr);
+}
+
+int mgr_add(struct _uart_mgr *mgr, struct _uart *uart, void *ctx)
+{
+    struct epoll_event ev;
+    struct mgr_port *p;
+
+    p = (struct mgr_port *) calloc(1, sizeof(*p));
+
+    if (!p) {
+        error("calloc() failed", 1);
+        return -1;
+    }
+
+    p->uart = uart;
+    p->mgr = mgr;
+    p->ctx = ctx;
+    p->events = EPOLLIN;
+    ev.events = EPOLLIN;
+    ev.data.ptr = p;
+    pthread_mutex_lock(&mgr->lock);
+
+    if (epoll_ctl(mgr->epfd, EPOLL_CTL_ADD, uart->fd, &ev) == -1) {
+        pthread_mutex_unlock(&mgr->lock);
+        error("epoll_ctl() failed", 1);
+        free(p);
+        return -1;
+    }
+
+    mgr_link(mgr, p);
+    pthread_mutex_unlock(&mgr->lock);
+    return 0;
+}
+
+void mgr_remove(struct _uart *uart)
+{
+    struct mgr_port *p = uart->mgr;
+    struct _uart_mgr *mgr = p->mgr;
+
+    pthread_mutex_lock(&mgr->lock);
+    mgr_detach(p);
+    pthread_mutex_unlock(&mgr->lock);
+    uart->mgr = NULL;
+}
+
+/*
+ * Hand a port and its buffered data over to another manager. Both locks
+ * are taken in address order, so moves in opposite directions can run
+ * at the same time.
+ */
+int mgr_move(struct _uart *uart, struct _uart_mgr *dst)
+{
+    struct mgr_port *p = uart->mgr;
+    struct _uart_mgr *src = p->mgr;
+    struct _uart_mgr *first;
+    struct _uart_mgr *second;
+    struct epoll_event ev;
+    struct mgr_port *np;
+    struct mgr_slab *s;
+    struct uart_rx_ts ts;
+    int ret = -1;
+    int n;
+
+    if (src == dst)
+        return 0;
+
+    np = (struct mgr_port *) calloc(1, sizeof(*np));
+
+    if (!np) {
+        error("calloc() failed", 1);
+        return -1;
+    }
+
+    np->uart = uart;
+    np->mgr = dst;
+    np->ctx = p->ctx;
+    first = (uintptr_t) src < (uintptr_t) dst ? src : dst;
+    second = first == src ? dst : src;
+    pthread_mutex_lock(&first->lock);
+    pthread_mutex_lock(&second->lock);
+
+    if (p->hung) {
+        error_code(UART_ERR_IO, "UART device hung up");
+        goto undo;
+    }
+
+    for (s = p->rx_head; s; s = s->next) {
+        n = s->len - s->off;
+
+        if (mgr_append(dst, &np->rx_head, &np->rx_tail, SLAB_DATA(s) + s->off,
+                       n) != n)
+            goto full;
+
+        /* a new slab starts with the data of this one */
+        if (!np->rx_tail->rx_ns) {
+            mgr_rx_ts(s, &ts, uart_char_ns(uart));
+            np->rx_tail->rx_ns = ts.rx_ns;
+            np->rx_tail->first_ns = ts.first_ns;
+            np->rx_tail->mark_rx_ns = ts.rx_ns;
+            np->rx_tail->mark_first_ns = ts.first_ns;
+        }
+    }
+
+    for (s = p->tx_head; s; s = s->next) {
+        n = s->len - s->off;
+
+        if (mgr_append(dst, &np->tx_head, &np->tx_tail, SLAB_DATA(s) + s->off,
+                       n) != n)
+            goto full;
+
+        np->tx_pending += n;
+    }
+
+    np->events = EPOLLIN | (np->tx_head ? EPOLLOUT : 0);
+    ev.events = np->events;
+    ev.data.ptr = np;
+
+    if (epoll_ctl(dst->epfd, EPOLL_CTL_ADD, uart->fd, &ev) == -1) {
+        error("epoll_ctl() failed", 1);
+        goto undo;
+    }
+
+    mgr_detach(p);
+    mgr_link(dst, np);
+    ret = 0;
+    goto out;
+
+full:
+    error_code(UART_ERR_STATE, "buffer pool of the target exhausted");
+
+undo:
+    mgr_slab_put_list(dst, np->rx_head);
+    mgr_slab_put_list(dst, np->tx_head);
+    free(np);
+
+out:
+    pthread_mutex_unlock(&second->lock);
+    pthread_mutex_unlock(&first->lock);
+    return ret;
+}
+
+/* poll a port again after its device was reopened */
+int mgr_resume(struct _uart *uart)
+{
+    struct mgr_port *p = uart->mgr;
+    struct _uart_mgr *mgr = p->mgr;
+    struct epoll_event ev;
+    int ret = 0;
+
+    pthread_mutex_lock(&mgr->lock);
+
+    if (p->hung) {
+        p->events = EPOLLIN | (p->tx_head ? EPOLLOUT : 0);
+        ev.events = p->events;
+        ev.data.ptr = p;
+
+        if (epoll_ctl(mgr->epfd, EPOLL_CTL_ADD, uart->fd, &ev) == -1) {
+            error("epoll_ctl() failed", 1);
+            ret = -1;
+        } else {
+            p->hung = 0;
+        }
+    }
+
+    pthread_mutex_unlock(&mgr->lock);
+    return ret;
+}
+
+void mgr_wake(struct _uart_mgr *mgr)
+{
+    uint64_t one = 1;
+
+    if (write(mgr->wake_fd, &one, sizeof(one)) == -1 && errno != EAGAIN)
+        error("write() failed", 1);
+}
+
+/*
+ * Level-triggered epoll queues a port that is still readable behind the
+ * other ready ports, so reading at most 'budget' bytes per port and
+ * event serves the ports round-robin.
+ */
+int mgr_poll(struct _uart_mgr *mgr, uart_t **ready, int max, int timeout_ms)
+{
+    struct epoll_event ev[MGR_EVENTS];
+    struct mgr_port *p;
+    long long now;
+    uint64_t cnt;
+    int nready = 0;
+    int report;
+    int ret;
+    int n;
+    int i;
+
+    pthread_mutex_lock(&mgr->lock);
+    mgr_reap(mgr);
+    mgr->wait_since = stats_now_ns();
+    pthread_mutex_unlock(&mgr->lock);
+
+    n = epoll_wait(mgr->epfd, ev, max < MGR_EVENTS ? max : MGR_EVENTS,
+                   timeout_ms);
+    now = stats_raw_ns();
+    pthread_mutex_lock(&mgr->lock);
+    mgr->wait_ns += stats_now_ns() - mgr->wait_since;
+    mgr->wait_since = 0;
+
+    if (n == -1) {
+        pthread_mutex_unlock(&mgr->lock);
+
+        if (errno == EINTR)
+            return 0;
+
+        error("epoll_wait() failed", 1);
+        return -1;
+    }
+
+    for (i = 0; i < n; i++) {
+        p = (struct mgr_port *) ev[i].data.ptr;
+        report = 0;
+
+        if (!p) {
+            if (read(mgr->wake_fd, &cnt, sizeof(cnt)) == -1 &&
+                errno != EAGAIN)
+                error("read() failed", 1);
+
+            continue;
+        }
+
+        /* removed after epoll_wait() returned */
+        if (!p->uart)
+            continue;
+
+        if ((ev[i].events & EPOLLOUT) && mgr_write(p) == -1) {
+            mgr_hangup(p);
+            report = 1;
+        }
+
+        if (!p->hung && (ev[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR))) {
+            ret = mgr_read(p, now);
+
+            if (ret == -1 || (ret == 0 && !p->blocked &&
+                              (ev[i].events & (EPOLLHUP | EPOLLERR))))
+                mgr_hangup(p);
+
+            report |= ret != 0 || p->hung;
+        }
+
+        /* a failed write or read noticed the lost device */
+        if (!p->hung && reconnect_pending(p->uart)) {
+            mgr_hangup(p);
+            report = 1;
+        }
+
+        if (report)
+            ready[nready++] = p->uart;
+    }
+
+    pthread_mutex_unlock(&mgr->lock);
+    return nready;
+}
+
+int mgr_send(struct _uart *uart, const char *send_buf, int len)
+{
+    struct mgr_port *p = uart->mgr;
+    struct _uart_mgr *mgr = p->mgr;
+    struct iovec iov;
+    int done = 0;
+    int ret = -1;
+
+    pthread_mutex_lock(&mgr->lock);
+
+    /* keep the data of a reconnecting port for mgr_resume() */
+    if (p->hung && !reconnect_pending(uart)) {
+        error_code(UART_ERR_IO, "UART device hung up");
+        goto out;
+    }
+
+    /* nothing queued, try to write without copying first */
+    if (!p->tx_head && !p->hung) {
+        iov.iov_base = (void *) send_buf;
+        iov.iov_len = len;
+        done = uart_sendv(uart, &iov, 1);
+
+        if (done == -1)
+            goto out;
+
+        mgr->tx_bytes += done;
+    }
+
+    ret = mgr_append(mgr, &p->tx_head, &p->tx_tail, send_buf + done,
+                     len - done);
+    p->tx_pending += ret;
+    done += ret;
+
+    if (mgr_arm(p) == -1)
+        goto out;
+
+    ret = done;
+
+out:
+    pthread_mutex_unlock(&mgr->lock);
+    return ret;
+}
+
+int mgr_recv(struct _uart *uart, char *recv_buf, int len,
+             struct uart_rx_ts *ts)
+{
+    struct mgr_port *p = uart->mgr;
+    struct _uart_mgr *mgr = p->mgr;
+    struct mgr_slab *s;
+    int copied = 0;
+    int n;
+
+    pthread_mutex_lock(&mgr->lock);
+
+    while (copied < len && (s = p->rx_head)) {
+        n = s->len - s->off;
+
+        if (ts && copied == 0)
+            mgr_rx_ts(s, ts, uart_char_ns(uart));
+
+        if (n > len - copied)
+            n = len - copied;
+
+        memcpy(recv_buf + copied, SLAB_DATA(s) + s->off, n);
+        s->off += n;
+        copied += n;
+
+        if (s->off == s->len) {
+            p->rx_head = s->next;
+
+            if (!p->rx_head)
+                p->rx_tail = NULL;
+
+            mgr_slab_put(mgr, s);
+        }
+    }
+
+    if (copied > 0)
+        mgr_unblock(mgr);
+    else if (p->hung && !reconnect_pending(uart))
+        copied = -1;
+
+    pthread_mutex_unlock(&mgr->lock);
+
+    if (copied == -1)
+        error_code(UART_ERR_IO, "UART device hung up");
+
+    return copied;
+}
+
+int mgr_tx_pending(struct _uart *uart)
+{
+    struct mgr_port *p = uart->mgr;
+    int ret;
+
+    pthread_mutex_lock(&p->mgr->lock);
+    ret = p->tx_pending;
+    pthread_mutex_unlock(&p->mgr->lock);
+    return ret;
+}
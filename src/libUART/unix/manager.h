@@ -0,0 +1,104 @@
+/**
+ *
+ * File Name: unix/manager.h
+ * Title    : UNIX UART port manager
+ * Project  : libUART
+ * Author   : Copyright (C) 2018-2020 Johannes Krottmayer <krjdev@gmail.com>
+ * Created  : 2026-10-19
+ * Modified :
+ * Revised  :
+ * Version  : 0.1.0.0
+ * License  : ISC (see file LICENSE.txt)
+ *
+ * NOTE: This code is currently below version 1.0, and therefore is considered
+ * to be lacking in some functionality or documentation, or may not be fully
+ * tested. Nonetheless, you can expect most functions to work.
+ *
+ */
+
+#ifndef LIBUART_UNIX_MANAGER_H
+#define LIBUART_UNIX_MANAGER_H
+
+#include <pthread.h>
+
+#include "../libUART.h"
+#include "../util.h"
+
+/* maximum number of epoll events handled per poll */
+#define MGR_EVENTS          64
+/* maximum number of slabs written with a single writev() */
+#define MGR_BATCH           64
+
+struct _uart;
+struct _uart_mgr;
+
+/* buffer taken from the shared pool, 'data' follows the header */
+struct mgr_slab {
+    struct mgr_slab *next;
+    int len;
+    int off;
+    long long rx_ns;            /* wakeup that read the first byte */
+    long long first_ns;         /* estimated arrival of the first byte */
+    int mark;                   /* first byte of the latest wakeup */
+    long long mark_rx_ns;
+    long long mark_first_ns;
+};
+
+/* per-port state, protected by the manager lock */
+struct mgr_port {
+    struct _uart *uart;
+    struct _uart_mgr *mgr;
+    void *ctx;
+    struct mgr_port *next;
+    struct mgr_port *prev;
+    struct mgr_slab *rx_head;
+    struct mgr_slab *rx_tail;
+    struct mgr_slab *tx_head;
+    struct mgr_slab *tx_tail;
+    int tx_pending;
+    unsigned int events;        /* epoll events currently armed */
+    int blocked;                /* waiting for a free slab */
+    int hung;                   /* device hung up, removed from epoll */
+};
+
+/*
+ * Ports removed while another thread sits in epoll_wait() may still be
+ * returned by it, so they are parked on 'dead' and freed by the next
+ * poll. Only one thread may poll a manager at a time. A write to
+ * 'wake_fd' makes a waiting poll return early.
+ */
+struct _uart_mgr {
+    int epfd;
+    int wake_fd;
+    pthread_mutex_t lock;
+    int slab_size;
+    size_t stride;
+    int budget;
+    char *pool;
+    struct mgr_slab *free;
+    int free_slabs;
+    int blocked;
+    struct mgr_port *ports;
+    struct mgr_port *dead;
+    int nports;
+    unsigned long long rx_bytes;
+    unsigned long long tx_bytes;
+    long long wait_ns;          /* time spent in epoll_wait() */
+    long long wait_since;       /* start of the current wait, 0 if busy */
+};
+
+extern struct _uart_mgr *mgr_create(int slab_size, int slabs, int budget);
+extern void mgr_destroy(struct _uart_mgr *mgr);
+extern int mgr_add(struct _uart_mgr *mgr, struct _uart *uart, void *ctx);
+extern void mgr_remove(struct _uart *uart);
+extern int mgr_move(struct _uart *uart, struct _uart_mgr *dst);
+extern int mgr_resume(struct _uart *uart);
+extern void mgr_wake(struct _uart_mgr *mgr);
+extern int mgr_poll(struct _uart_mgr *mgr, uart_t **ready, int max,
+                    int timeout_ms);
+extern int mgr_send(struct _uart *uart, const char *send_buf, int len);
+extern int mgr_recv(struct _uart *uart, char *recv_buf, int len,
+                    struct uart_rx_ts *ts);
+extern int mgr_tx_pending(struct _uart *uart);
+
+#endif
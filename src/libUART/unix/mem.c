@@ -0,0 +1,361 @@
+/**
+ *
+ * File Name: unix/mem.c
+ * Title    : UNIX UART in-memory pipe backend
+ * Project  : libUART
+ * Author   : Copyright (C) 2018-2020 Johannes Krottmayer <krjdev@gmail.com>
+ * Created  : 2026-10-19
+ * Modified :
+ * Revised  :
+ * Version  : 0.1.0.0
+ * License  : ISC (see file LICENSE.txt)
+ *
+ * NOTE: This code is currently below version 1.0, and therefore is considered
+ * to be lacking in some functionality or documentation, or may not be fully
+ * tested. Nonetheless, you can expect most functions to work.
+ *
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/eventfd.h>
+#include <sys/ioctl.h>
+
+#include "error.h"
+#include "backend.h"
+
+/*
+ * Two ports opened with the same "mem:" name are connected by a pair of
+ * ring buffers. The data is copied in user space, the eventfd of an end
+ * is only touched when its ring turns empty or non-empty, so poll() and
+ * epoll see the port readable. The eventfd is always writable, a full
+ * ring refuses data with EAGAIN.
+ */
+struct mem_pipe;
+
+struct mem_end {
+    struct mem_pipe *pipe;
+    int idx;
+};
+
+struct mem_ring {
+    unsigned int head;          /* free running, masked on access */
+    unsigned int tail;
+    char data[MEM_RING_SIZE];
+};
+
+struct mem_pipe {
+    struct mem_pipe *next;
+    char name[DEV_NAME_LEN];
+    pthread_mutex_t lock;
+    int opened;
+    int closed;                 /* the other end of an open port is gone */
+    struct _uart *uart[2];
+    int ev[2];
+    int signalled[2];
+    struct mem_end end[2];
+    struct mem_ring ring[2];    /* ring[i] is read by end i */
+};
+
+static pthread_mutex_t g_lock = PTHREAD_MUTEX_INITIALIZER;
+static struct mem_pipe *g_pipes;
+
+/* called with the lock of the pipe held */
+static void mem_signal(struct mem_pipe *p, int idx)
+{
+    if (p->ev[idx] == -1 || p->signalled[idx])
+        return;
+
+    eventfd_write(p->ev[idx], 1);
+    p->signalled[idx] = 1;
+}
+
+static void mem_unsignal(struct mem_pipe *p, int idx)
+{
+    eventfd_t cnt;
+
+    if (!p->signalled[idx])
+        return;
+
+    eventfd_read(p->ev[idx], &cnt);
+    p->signalled[idx] = 0;
+}
+
+static struct mem_pipe *mem_create(const char *name)
+{
+    struct mem_pipe *p;
+    int i;
+
+    p = (struct mem_pipe *) calloc(1, sizeof(*p));
+
+    if (!p) {
+        error("calloc() failed", 1);
+        return NULL;
+    }
+
+    strcpy(p->name, name);
+    pthread_mutex_init(&p->lock, NULL);
+
+    for (i = 0; i < 2; i++) {
+        p->ev[i] = -1;
+        p->end[i].pipe = p;
+        p->end[i].idx = i;
+    }
+
+    p->next = g_pipes;
+    g_pipes = p;
+    return p;
+}
+
+static void mem_free(struct mem_pipe *p)
+{
+    struct mem_pipe **pp;
+
+    for (pp = &g_pipes; (*pp); pp = &(*pp)->next) {
+        if ((*pp) == p) {
+            (*pp) = p->next;
+            break;
+        }
+    }
+
+    pthread_mutex_destroy(&p->lock);
+    free(p);
+}
+
+/* the first port creates the pipe, the second one connects to it */
+static int mem_open(struct _uart *uart, const char *name)
+{
+    struct mem_pipe *p;
+    int idx;
+    int fd;
+
+    if (!name[0]) {
+        error_code(UART_ERR_INVAL, "invalid memory pipe name");
+        return -1;
+    }
+
+    pthread_mutex_lock(&g_lock);
+
+    for (p = g_pipes; p; p = p->next) {
+        if (strcmp(p->name, name) == 0)
+            break;
+    }
+
+    if (p && p->opened == 2) {
+        pthread_mutex_unlock(&g_lock);
+        error_code(UART_ERR_STATE, "memory pipe already connected");
+        return -1;
+    }
+
+    fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+
+    if (fd == -1) {
+        pthread_mutex_unlock(&g_lock);
+        error("eventfd() failed", 1);
+        return -1;
+    }
+
+    if (!p && !(p = mem_create(name))) {
+        pthread_mutex_unlock(&g_lock);
+        close(fd);
+        return -1;
+    }
+
+    pthread_mutex_lock(&p->lock);
+    idx = p->opened++;
+    p->uart[idx] = uart;
+    p->ev[idx] = fd;
+
+    /* data sent before this end was connected, or the other end is gone */
+    if (p->ring[idx].head != p->ring[idx].tail || p->closed)
+        mem_signal(p, idx);
+
+    pthread_mutex_unlock(&p->lock);
+    pthread_mutex_unlock(&g_lock);
+    uart->be_priv = &p->end[idx];
+    atomic_store(&uart->modem, 0);
+    return fd;
+}
+
+static void mem_close(struct _uart *uart)
+{
+    struct mem_end *e = (struct mem_end *) uart->be_priv;
+    struct mem_pipe *p = e->pipe;
+    int done;
+
+    pthread_mutex_lock(&g_lock);
+    pthread_mutex_lock(&p->lock);
+    p->closed++;
+    p->uart[e->idx] = NULL;
+    close(p->ev[e->idx]);
+    p->ev[e->idx] = -1;
+    p->signalled[e->idx] = 0;
+
+    /* the other end reads the rest of the data, then fails with EIO */
+    mem_signal(p, !e->idx);
+    done = p->closed == p->opened;
+    pthread_mutex_unlock(&p->lock);
+
+    if (done)
+        mem_free(p);
+
+    pthread_mutex_unlock(&g_lock);
+    uart->be_priv = NULL;
+}
+
+static ssize_t mem_read(struct _uart *uart, void *buf, size_t len)
+{
+    struct mem_end *e = (struct mem_end *) uart->be_priv;
+    struct mem_pipe *p = e->pipe;
+    struct mem_ring *r = &p->ring[e->idx];
+    unsigned int off;
+    size_t first;
+    size_t n;
+
+    pthread_mutex_lock(&p->lock);
+    n = r->head - r->tail;
+
+    if (n == 0) {
+        errno = p->closed ? EIO : EAGAIN;
+        pthread_mutex_unlock(&p->lock);
+        return -1;
+    }
+
+    if (n > len)
+        n = len;
+
+    off = r->tail & (MEM_RING_SIZE - 1);
+    first = MEM_RING_SIZE - off;
+
+    if (first > n)
+        first = n;
+
+    memcpy(buf, r->data + off, first);
+    memcpy((char *) buf + first, r->data, n - first);
+    r->tail += n;
+
+    if (r->head == r->tail && !p->closed)
+        mem_unsignal(p, e->idx);
+
+    pthread_mutex_unlock(&p->lock);
+    return n;
+}
+
+static ssize_t mem_writev(struct _uart *uart, const struct iovec *iov, int cnt)
+{
+    struct mem_end *e = (struct mem_end *) uart->be_priv;
+    struct mem_pipe *p = e->pipe;
+    struct mem_ring *r = &p->ring[!e->idx];
+    unsigned int off;
+    size_t space;
+    size_t total = 0;
+    size_t first;
+    size_t n;
+    int i;
+
+    pthread_mutex_lock(&p->lock);
+
+    if (p->closed) {
+        pthread_mutex_unlock(&p->lock);
+        errno = EIO;
+        return -1;
+    }
+
+    space = MEM_RING_SIZE - (r->head - r->tail);
+
+    for (i = 0; i < cnt && space > 0; i++) {
+        n = iov[i].iov_len < space ? iov[i].iov_len : space;
+        off = r->head & (MEM_RING_SIZE - 1);
+        first = MEM_RING_SIZE - off;
+
+        if (first > n)
+            first = n;
+
+        memcpy(r->data + off, iov[i].iov_base, first);
+        memcpy(r->data, (const char *) iov[i].iov_base + first, n - first);
+        r->head += n;
+        space -= n;
+        total += n;
+    }
+
+    if (total == 0 && cnt > 0 && space == 0) {
+        pthread_mutex_unlock(&p->lock);
+        errno = EAGAIN;
+        return -1;
+    }
+
+    if (total > 0)
+        mem_signal(p, !e->idx);
+
+    pthread_mutex_unlock(&p->lock);
+    return total;
+}
+
+/* RTS of one end is CTS of the other, DTR is DSR and DCD */
+static int mem_get_pins(struct _uart *uart, int *status)
+{
+    struct mem_end *e = (struct mem_end *) uart->be_priv;
+    struct mem_pipe *p = e->pipe;
+    struct _uart *peer;
+    int out;
+    int in = 0;
+
+    pthread_mutex_lock(&p->lock);
+    peer = p->uart[!e->idx];
+
+    if (peer) {
+        out = atomic_load(&peer->modem);
+
+        if (out & TIOCM_RTS)
+            in |= TIOCM_CTS;
+
+        if (out & TIOCM_DTR)
+            in |= TIOCM_DSR | TIOCM_CAR;
+    }
+
+    pthread_mutex_unlock(&p->lock);
+    (*status) = atomic_load(&uart->modem) | in;
+    return 0;
+}
+
+static int mem_set_pins(struct _uart *uart, int status)
+{
+    atomic_store(&uart->modem, status & (TIOCM_RTS | TIOCM_DTR));
+    return 0;
+}
+
+static int mem_bytes_available(struct _uart *uart, int *bytes)
+{
+    struct mem_end *e = (struct mem_end *) uart->be_priv;
+    struct mem_pipe *p = e->pipe;
+    struct mem_ring *r = &p->ring[e->idx];
+
+    pthread_mutex_lock(&p->lock);
+    (*bytes) = r->head - r->tail;
+    pthread_mutex_unlock(&p->lock);
+    return 0;
+}
+
+/* sent data is in the ring of the other end already */
+static int mem_flush(struct _uart *uart)
+{
+    (void) uart;
+    return 0;
+}
+
+const struct uart_backend backend_mem = {
+    .prefix = "mem:",
+    .flags = 0,
+    .open = mem_open,
+    .close = mem_close,
+    .read = mem_read,
+    .writev = mem_writev,
+    .configure = backend_conf_keep,
+    .get_pins = mem_get_pins,
+    .set_pins = mem_set_pins,
+    .bytes_available = mem_bytes_available,
+    .flush = mem_flush
+};
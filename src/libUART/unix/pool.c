@@ -0,0 +1,381 @@
+/**
+ *
+ * File Name: unix/pool.c
+ * Title    : UNIX UART sharded worker pool
+ * Project  : libUART
+ * Author   : Copyright (C) 2018-2020 Johannes Krottmayer <krjdev@gmail.com>
+ * Created  : 2026-10-19
+ * Modified :
+ * Revised  :
+ * Version  : 0.1.0.0
+ * License  : ISC (see file LICENSE.txt)
+ *
+ * NOTE: This code is currently below version 1.0, and therefore is considered
+ * to be lacking in some functionality or documentation, or may not be fully
+ * tested. Nonetheless, you can expect most functions to work.
+ *
+ */
+
+/* pthread_attr_setaffinity_np() */
+#define _GNU_SOURCE
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <sched.h>
+
+#include "error.h"
+#include "stats.h"
+#include "uart.h"
+#include "pool.h"
+
+static void pool_exec(struct pool_shard *sh, struct pool_cmd *cmd)
+{
+    pthread_rwlock_wrlock(&sh->pool->owner);
+    uart_reopen_lock();
+
+    /* removed or moved since the requester looked up the shard */
+    cmd->lost = !cmd->uart->mgr || cmd->uart->mgr->mgr != sh->mgr;
+
+    if (cmd->lost) {
+        cmd->ret = -1;
+        goto out;
+    }
+
+    switch (cmd->op) {
+    case POOL_OP_REMOVE:
+        mgr_remove(cmd->uart);
+        cmd->ret = 0;
+        break;
+    case POOL_OP_MOVE:
+        cmd->ret = mgr_move(cmd->uart, cmd->dst);
+        break;
+    default:
+        cmd->ret = -1;
+        break;
+    }
+
+out:
+    uart_reopen_unlock();
+    pthread_rwlock_unlock(&sh->pool->owner);
+}
+
+static void *pool_thread(void *arg)
+{
+    struct pool_shard *sh = (struct pool_shard *) arg;
+    uart_t *ready[MGR_EVENTS];
+    int calls;
+    int n;
+    int i;
+
+    while (!atomic_load_explicit(&sh->stop, memory_order_acquire)) {
+        if (atomic_load_explicit(&sh->cmd_pending, memory_order_acquire)) {
+            pool_exec(sh, &sh->cmd);
+            atomic_store_explicit(&sh->cmd_pending, 0, memory_order_release);
+            sem_post(&sh->cmd_done);
+        }
+
+        n = mgr_poll(sh->mgr, ready, MGR_EVENTS, -1);
+
+        if (n <= 0)
+            continue;
+
+        atomic_fetch_add_explicit(&sh->wakeups, 1, memory_order_relaxed);
+
+        /*
+         * The ports are owned by this thread, only a callback may have
+         * moved or removed one of them meanwhile.
+         */
+        for (i = 0, calls = 0; i < n; i++) {
+            if (ready[i]->mgr && ready[i]->mgr->mgr == sh->mgr) {
+                sh->pool->cb(ready[i], ready[i]->mgr->ctx);
+                calls++;
+            }
+        }
+
+        atomic_fetch_add_explicit(&sh->callbacks, calls,
+                                  memory_order_relaxed);
+    }
+
+    return NULL;
+}
+
+/* run a request in the worker owning the port, or right away in a callback */
+static int pool_request(struct _uart_pool *pool, struct pool_shard *sh,
+                        struct pool_cmd *cmd)
+{
+    int i;
+
+    if (pthread_equal(pthread_self(), sh->thread)) {
+        pool_exec(sh, cmd);
+        return cmd->ret;
+    }
+
+    /* waiting for another worker from a callback could deadlock */
+    for (i = 0; i < pool->shards; i++) {
+        if (pthread_equal(pthread_self(), pool->shard[i].thread)) {
+            error_code(UART_ERR_STATE, "port is owned by another worker");
+            return -1;
+        }
+    }
+
+    pthread_mutex_lock(&pool->ctl);
+    sh->cmd = (*cmd);
+    atomic_store_explicit(&sh->cmd_pending, 1, memory_order_release);
+    mgr_wake(sh->mgr);
+
+    while (sem_wait(&sh->cmd_done) == -1 && errno == EINTR)
+        ;
+
+    (*cmd) = sh->cmd;
+    pthread_mutex_unlock(&pool->ctl);
+    return cmd->ret;
+}
+
+static int pool_start(struct pool_shard *sh, int priority)
+{
+    struct sched_param param;
+    pthread_attr_t attr;
+    cpu_set_t set;
+    int ret;
+
+    pthread_attr_init(&attr);
+
+    if (sh->cpu >= 0) {
+        CPU_ZERO(&set);
+        CPU_SET(sh->cpu, &set);
+        pthread_attr_setaffinity_np(&attr, sizeof(set), &set);
+    }
+
+    if (priority > 0) {
+        memset(&param, 0, sizeof(param));
+        param.sched_priority = priority;
+        pthread_attr_setinheritsched(&attr, PTHREAD_EXPLICIT_SCHED);
+        pthread_attr_setschedpolicy(&attr, SCHED_FIFO);
+        pthread_attr_setschedparam(&attr, &param);
+    }
+
+    ret = pthread_create(&sh->thread, &attr, pool_thread, sh);
+    pthread_attr_destroy(&attr);
+
+    if (ret != 0) {
+        errno = ret;
+        error("pthread_create() failed", 1);
+        return -1;
+    }
+
+    return 0;
+}
+
+static void pool_free(struct _uart_pool *pool, int started)
+{
+    struct pool_shard *sh;
+    int i;
+
+    for (i = 0; i < pool->shards; i++) {
+        sh = &pool->shard[i];
+
+        if (i < started) {
+            atomic_store_explicit(&sh->stop, 1, memory_order_release);
+            mgr_wake(sh->mgr);
+            pthread_join(sh->thread, NULL);
+        }
+
+        /* closes the ports still owned by the shard */
+        if (sh->mgr)
+            mgr_destroy(sh->mgr);
+
+        sem_destroy(&sh->cmd_done);
+    }
+
+    pthread_mutex_destroy(&pool->ctl);
+    pthread_rwlock_destroy(&pool->owner);
+    free(pool->shard);
+    free(pool);
+}
+
+struct _uart_pool *pool_create(const struct uart_pool_cfg *cfg,
+                               uart_pool_cb cb)
+{
+    struct _uart_pool *pool;
+    struct pool_shard *sh;
+    int ret;
+    int i;
+
+    pool = (struct _uart_pool *) calloc(1, sizeof(*pool));
+
+    if (!pool) {
+        error("calloc() failed", 1);
+        return NULL;
+    }
+
+    ret = posix_memalign((void **) &pool->shard, CACHE_LINE_SIZE,
+                         cfg->workers * sizeof(*pool->shard));
+
+    if (ret != 0) {
+        errno = ret;
+        error("posix_memalign() failed", 1);
+        free(pool);
+        return NULL;
+    }
+
+    memset(pool->shard, 0, cfg->workers * sizeof(*pool->shard));
+    pool->shards = cfg->workers;
+    pool->cb = cb;
+    pool->start_ns = stats_now_ns();
+    pthread_mutex_init(&pool->ctl, NULL);
+    pthread_rwlock_init(&pool->owner, NULL);
+
+    for (i = 0; i < pool->shards; i++) {
+        sh = &pool->shard[i];
+        sh->pool = pool;
+        sh->cpu = cfg->cpus ? cfg->cpus[i] : -1;
+        atomic_init(&sh->stop, 0);
+        atomic_init(&sh->cmd_pending, 0);
+        atomic_init(&sh->wakeups, 0);
+        atomic_init(&sh->callbacks, 0);
+        sem_init(&sh->cmd_done, 0, 0);
+    }
+
+    for (i = 0; i < pool->shards; i++) {
+        sh = &pool->shard[i];
+        sh->mgr = mgr_create(cfg->slab_size, cfg->slabs, cfg->budget);
+
+        if (!sh->mgr) {
+            pool_free(pool, 0);
+            return NULL;
+        }
+    }
+
+    for (i = 0; i < pool->shards; i++) {
+        if (pool_start(&pool->shard[i], cfg->priority) == -1) {
+            pool_free(pool, i);
+            return NULL;
+        }
+    }
+
+    return pool;
+}
+
+void pool_destroy(struct _uart_pool *pool)
+{
+    pool_free(pool, pool->shards);
+}
+
+int pool_shard_of(struct _uart_pool *pool, struct _uart *uart)
+{
+    int ret = -1;
+    int i;
+
+    pthread_rwlock_rdlock(&pool->owner);
+
+    for (i = 0; uart->mgr && i < pool->shards; i++) {
+        if (pool->shard[i].mgr == uart->mgr->mgr) {
+            ret = i;
+            break;
+        }
+    }
+
+    pthread_rwlock_unlock(&pool->owner);
+    return ret;
+}
+
+int pool_add(struct _uart_pool *pool, struct _uart *uart, int shard,
+             void *ctx)
+{
+    int least = -1;
+    int nports;
+    int ret;
+    int i;
+
+    /* fewest ports first, the application rebalances by load */
+    if (shard < 0) {
+        for (i = 0; i < pool->shards; i++) {
+            pthread_mutex_lock(&pool->shard[i].mgr->lock);
+            nports = pool->shard[i].mgr->nports;
+            pthread_mutex_unlock(&pool->shard[i].mgr->lock);
+
+            if (least == -1 || nports < least) {
+                least = nports;
+                shard = i;
+            }
+        }
+    }
+
+    pthread_rwlock_wrlock(&pool->owner);
+    ret = mgr_add(pool->shard[shard].mgr, uart, ctx);
+    pthread_rwlock_unlock(&pool->owner);
+    return ret;
+}
+
+/*
+ * The owner is looked up once. The worker checks it again under the owner
+ * lock, the port may be removed or moved before the request runs.
+ */
+static int pool_port_cmd(struct _uart_pool *pool, struct _uart *uart, int op,
+                         struct _uart_mgr *dst)
+{
+    struct pool_cmd cmd;
+    int shard;
+
+    shard = pool_shard_of(pool, uart);
+
+    if (shard == -1) {
+        error_code(UART_ERR_STATE, "port is not in <uart_pool_t>");
+        return -1;
+    }
+
+    cmd.op = op;
+    cmd.uart = uart;
+    cmd.dst = dst;
+    cmd.lost = 0;
+
+    if (pool_request(pool, &pool->shard[shard], &cmd) == -1) {
+        if (cmd.lost)
+            error_code(UART_ERR_STATE, "port is not in <uart_pool_t>");
+
+        return -1;
+    }
+
+    return cmd.ret;
+}
+
+int pool_remove(struct _uart_pool *pool, struct _uart *uart)
+{
+    return pool_port_cmd(pool, uart, POOL_OP_REMOVE, NULL);
+}
+
+int pool_move(struct _uart_pool *pool, struct _uart *uart, int shard)
+{
+    return pool_port_cmd(pool, uart, POOL_OP_MOVE, pool->shard[shard].mgr);
+}
+
+void pool_get_load(struct _uart_pool *pool, int shard,
+                   struct uart_shard_load *load)
+{
+    struct pool_shard *sh = &pool->shard[shard];
+    long long elapsed;
+    long long wait;
+
+    memset(load, 0, sizeof(*load));
+    load->cpu = sh->cpu;
+    pthread_mutex_lock(&sh->mgr->lock);
+    load->ports = sh->mgr->nports;
+    load->rx_bytes = sh->mgr->rx_bytes;
+    load->tx_bytes = sh->mgr->tx_bytes;
+    elapsed = stats_now_ns();
+    wait = sh->mgr->wait_ns;
+
+    if (sh->mgr->wait_since)
+        wait += elapsed - sh->mgr->wait_since;
+
+    pthread_mutex_unlock(&sh->mgr->lock);
+    load->wakeups = atomic_load_explicit(&sh->wakeups, memory_order_relaxed);
+    load->callbacks = atomic_load_explicit(&sh->callbacks,
+                                           memory_order_relaxed);
+    elapsed -= pool->start_ns;
+    load->elapsed_ms = elapsed / 1000000;
+
+    if (elapsed > 0 && wait < elapsed)
+        load->utilization = (double) (elapsed - wait) / elapsed;
+}
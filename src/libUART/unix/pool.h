@@ -0,0 +1,82 @@
+/**
+ *
+ * File Name: unix/pool.h
+ * Title    : UNIX UART sharded worker pool
+ * Project  : libUART
+ * Author   : Copyright (C) 2018-2020 Johannes Krottmayer <krjdev@gmail.com>
+ * Created  : 2026-10-19
+ * Modified :
+ * Revised  :
+ * Version  : 0.1.0.0
+ * License  : ISC (see file LICENSE.txt)
+ *
+ * NOTE: This code is currently below version 1.0, and therefore is considered
+ * to be lacking in some functionality or documentation, or may not be fully
+ * tested. Nonetheless, you can expect most functions to work.
+ *
+ */
+
+#ifndef LIBUART_UNIX_POOL_H
+#define LIBUART_UNIX_POOL_H
+
+#include <pthread.h>
+#include <semaphore.h>
+#include <stdatomic.h>
+
+#include "../libUART.h"
+#include "../util.h"
+#include "manager.h"
+
+enum e_pool_op {
+    POOL_OP_REMOVE,
+    POOL_OP_MOVE
+};
+
+/* request executed by a worker between two polls */
+struct pool_cmd {
+    int op;
+    struct _uart *uart;
+    struct _uart_mgr *dst;
+    int ret;
+    int lost;                   /* the shard did not own the port anymore */
+};
+
+/*
+ * One worker thread and the ports it owns. Nothing is shared between
+ * shards: every shard has its own manager (epoll set, buffer pool and
+ * lock), so workers never contend with each other.
+ */
+struct pool_shard {
+    _Alignas(CACHE_LINE_SIZE) struct _uart_mgr *mgr;
+    struct _uart_pool *pool;
+    int cpu;
+    pthread_t thread;
+    atomic_int stop;
+    atomic_int cmd_pending;
+    struct pool_cmd cmd;
+    sem_t cmd_done;
+    atomic_ullong wakeups;
+    atomic_ullong callbacks;
+};
+
+struct _uart_pool {
+    int shards;
+    struct pool_shard *shard;
+    uart_pool_cb cb;
+    long long start_ns;
+    pthread_mutex_t ctl;        /* serializes requests to the workers */
+    pthread_rwlock_t owner;     /* protects which shard owns a port */
+};
+
+extern struct _uart_pool *pool_create(const struct uart_pool_cfg *cfg,
+                                      uart_pool_cb cb);
+extern void pool_destroy(struct _uart_pool *pool);
+extern int pool_add(struct _uart_pool *pool, struct _uart *uart, int shard,
+                    void *ctx);
+extern int pool_remove(struct _uart_pool *pool, struct _uart *uart);
+extern int pool_move(struct _uart_pool *pool, struct _uart *uart, int shard);
+extern int pool_shard_of(struct _uart_pool *pool, struct _uart *uart);
+extern void pool_get_load(struct _uart_pool *pool, int shard,
+                          struct uart_shard_load *load);
+
+#endif
@@ -0,0 +1,417 @@
+/**
+ *
+ * File Name: unix/reader.c
+ * Title    : UNIX UART reader thread
+ * Project  : libUART
+ * Author   : Copyright (C) 2018-2020 Johannes Krottmayer <krjdev@gmail.com>
+ * Created  : 2026-10-19
+ * Modified :
+ * Revised  :
+ * Version  : 0.1.0.0
+ * License  : ISC (see file LICENSE.txt)
+ *
+ * NOTE: This code is currently below version 1.0, and therefore is considered
+ * to be lacking in some functionality or documentation, or may not be fully
+ * tested. Nonetheless, you can expect most functions to work.
+ *
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <poll.h>
+#include <unistd.h>
+
+#include "../libUART.h"
+#include "error.h"
+#include "stats.h"
+#include "uart.h"
+#include "reader.h"
+#include "reconnect.h"
+
+/* time to back off while the consumer has not freed a chunk */
+#define READER_FULL_WAIT_MS     1
+
+static void *reader_thread(void *arg)
+{
+    struct reader *r = (struct reader *) arg;
+    struct pollfd pfd[2];
+    unsigned int head;
+    char *chunk;
+    long long now;
+    int hangup = 0;
+    int ret;
+
+    pfd[0].fd = r->uart->fd;
+    pfd[0].events = POLLIN;
+    pfd[1].fd = r->stop_fd[0];
+    pfd[1].events = POLLIN;
+    head = atomic_load_explicit(&r->head, memory_order_relaxed);
+
+    while (1) {
+        /* ring full, leave the data in the kernel until a chunk is free */
+        if (head - r->tail_cache > r->mask) {
+            r->tail_cache = atomic_load_explicit(&r->tail,
+                                                 memory_order_acquire);
+
+            if (head - r->tail_cache > r->mask) {
+                if (poll(&pfd[1], 1, READER_FULL_WAIT_MS) != 0)
+                    break;
+
+                continue;
+            }
+        }
+
+        ret = poll(pfd, 2, -1);
+
+        if (ret == -1) {
+            if (errno == EINTR)
+                continue;
+
+            error("poll() failed", 1);
+            break;
+        }
+
+        /* the data arrived before the thread woke up */
+        now = stats_raw_ns();
+
+        if (pfd[1].revents)
+            break;
+
+        if (!(pfd[0].revents & POLLIN)) {
+            hangup = 1;
+            break;
+        }
+
+        chunk = r->pool + (size_t) (head & r->mask) * r->chunk_size;
+        ret = uart_recv(r->uart, chunk, r->chunk_size);
+
+        if (ret == -1)
+            break;
+
+        if (ret == 0) {
+            /* a hung up tty reads as end of file */
+            if (pfd[0].revents & (POLLHUP | POLLERR)) {
+                hangup = 1;
+                break;
+            }
+
+            continue;
+        }
+
+        r->len[head & r->mask] = ret;
+        uart_rx_ts_set(r->uart, &r->ts[head & r->mask], now, ret);
+        head++;
+        atomic_store_explicit(&r->head, head, memory_order_release);
+    }
+
+    atomic_store_explicit(&r->running, 0, memory_order_release);
+
+    /* reader_resume() restarts the thread after the reopen */
+    if (hangup && !(r->uart->rc && reconnect_lost(r->uart)))
+        error_code(UART_ERR_IO, "UART device hung up");
+
+    return NULL;
+}
+
+static void reader_free(struct reader *r)
+{
+    free(r->len);
+    free(r->ts);
+    free(r->pool);
+    free(r);
+}
+
+int reader_create(struct _uart *uart, int chunk_size, int chunks)
+{
+    struct reader *r;
+    int ret;
+
+    if (uart->reader) {
+        error_code(UART_ERR_STATE, "receive ring already in use");
+        return -1;
+    }
+
+    ret = posix_memalign((void **) &r, CACHE_LINE_SIZE, sizeof(*r));
+
+    if (ret != 0) {
+        errno = ret;
+        error("posix_memalign() failed", 1);
+        return -1;
+    }
+
+    memset(r, 0, sizeof(*r));
+    r->uart = uart;
+    r->mask = chunks - 1;
+    r->chunk_size = chunk_size;
+    r->len = (int *) calloc(chunks, sizeof(int));
+    r->ts = (struct uart_rx_ts *) calloc(chunks, sizeof(struct uart_rx_ts));
+    r->pool = (char *) malloc((size_t) chunks * chunk_size);
+
+    if (!r->len || !r->ts || !r->pool) {
+        error("malloc() failed", 1);
+        reader_free(r);
+        return -1;
+    }
+
+    atomic_init(&r->head, 0);
+    atomic_init(&r->tail, 0);
+    atomic_init(&r->running, 0);
+    uart->reader = r;
+    return 0;
+}
+
+int reader_start(struct _uart *uart, int chunk_size, int chunks)
+{
+    struct reader *r;
+    int ret;
+
+    if (reader_create(uart, chunk_size, chunks) == -1)
+        return -1;
+
+    r = uart->reader;
+
+    if (pipe(r->stop_fd) == -1) {
+        error("pipe() failed", 1);
+        reader_free(r);
+        uart->reader = NULL;
+        return -1;
+    }
+
+    r->threaded = 1;
+    atomic_store(&r->running, 1);
+    ret = pthread_create(&r->thread, NULL, reader_thread, r);
+
+    if (ret != 0) {
+        errno = ret;
+        error("pthread_create() failed", 1);
+        close(r->stop_fd[0]);
+        close(r->stop_fd[1]);
+        reader_free(r);
+        uart->reader = NULL;
+        return -1;
+    }
+
+    return 0;
+}
+
+void reader_stop(struct _uart *uart)
+{
+    struct reader *r = uart->reader;
+    char c = 0;
+
+    if (!r)
+        return;
+
+    if (r->threaded) {
+        if (write(r->stop_fd[1], &c, 1) == -1)
+            error("write() failed", 1);
+
+        pthread_join(r->thread, NULL);
+        close(r->stop_fd[0]);
+        close(r->stop_fd[1]);
+    }
+
+    reader_free(r);
+    uart->reader = NULL;
+}
+
+/* restart a reader thread that stopped when the device went away */
+int reader_resume(struct _uart *uart)
+{
+    struct reader *r = uart->reader;
+    int ret;
+
+    if (!r || !r->threaded ||
+        atomic_load_explicit(&r->running, memory_order_acquire))
+        return 0;
+
+    pthread_join(r->thread, NULL);
+    atomic_store(&r->running, 1);
+    ret = pthread_create(&r->thread, NULL, reader_thread, r);
+
+    if (ret != 0) {
+        atomic_store(&r->running, 0);
+        r->threaded = 0;
+        close(r->stop_fd[0]);
+        close(r->stop_fd[1]);
+        errno = ret;
+        error("pthread_create() failed", 1);
+        return -1;
+    }
+
+    return 0;
+}
+
+/* returns 1 if the chunk at 'head' is free for the producer */
+static int reader_room(struct reader *r, unsigned int head)
+{
+    if (head - r->tail_cache <= r->mask)
+        return 1;
+
+    r->tail_cache = atomic_load_explicit(&r->tail, memory_order_acquire);
+    return head - r->tail_cache <= r->mask;
+}
+
+int reader_full(struct _uart *uart)
+{
+    struct reader *r = uart->reader;
+
+    return !reader_room(r, atomic_load_explicit(&r->head,
+                                                memory_order_relaxed));
+}
+
+/*
+ * Producer step for event-loop mode, reads until the port or ring is
+ * empty. The call follows the wakeup of the event loop, so all chunks
+ * read get its time and the arrival of their bytes is estimated from the
+ * whole batch.
+ */
+int reader_fill(struct _uart *uart)
+{
+    struct reader *r = uart->reader;
+    unsigned int first;
+    unsigned int head;
+    long long now;
+    long long char_ns;
+    long long arrival;
+    char *chunk;
+    int total = 0;
+    int ret = 0;
+
+    now = stats_raw_ns();
+    head = atomic_load_explicit(&r->head, memory_order_relaxed);
+    first = head;
+
+    /* the chunks are published together once their times are known */
+    while (reader_room(r, head)) {
+        chunk = r->pool + (size_t) (head & r->mask) * r->chunk_size;
+        ret = uart_recv(uart, chunk, r->chunk_size);
+
+        if (ret <= 0)
+            break;
+
+        r->len[head & r->mask] = ret;
+        total += ret;
+        head++;
+
+        if (ret < r->chunk_size)
+            break;
+    }
+
+    char_ns = uart_char_ns(uart);
+    arrival = now - (total - 1) * char_ns;
+
+    for (; first != head; first++) {
+        r->ts[first & r->mask].rx_ns = now;
+        r->ts[first & r->mask].first_ns = arrival;
+        arrival += r->len[first & r->mask] * char_ns;
+    }
+
+    atomic_store_explicit(&r->head, head, memory_order_release);
+    return ret == -1 ? -1 : total;
+}
+
+/* returns 1 if a chunk is ready for the consumer */
+static int reader_ready(struct reader *r, unsigned int tail)
+{
+    if (tail != r->head_cache)
+        return 1;
+
+    r->head_cache = atomic_load_explicit(&r->head, memory_order_acquire);
+    return tail != r->head_cache;
+}
+
+int reader_recv(struct _uart *uart, char *recv_buf, int len,
+                struct uart_rx_ts *ts)
+{
+    struct reader *r = uart->reader;
+    unsigned int tail;
+    unsigned int idx;
+    int copied = 0;
+    int n;
+
+    tail = atomic_load_explicit(&r->tail, memory_order_relaxed);
+
+    while (copied < len && reader_ready(r, tail)) {
+        idx = tail & r->mask;
+        n = r->len[idx] - r->pos;
+
+        /* the bytes of a chunk were read at once */
+        if (ts && copied == 0) {
+            ts->rx_ns = r->ts[idx].rx_ns;
+            ts->first_ns = r->ts[idx].first_ns + r->pos * uart_char_ns(uart);
+        }
+
+        if (n > len - copied)
+            n = len - copied;
+
+        memcpy(recv_buf + copied,
+               r->pool + (size_t) idx * r->chunk_size + r->pos, n);
+        copied += n;
+        r->pos += n;
+
+        if (r->pos == (unsigned int) r->len[idx]) {
+            r->pos = 0;
+            tail++;
+        }
+    }
+
+    atomic_store_explicit(&r->tail, tail, memory_order_release);
+
+    if (copied > 0 || !r->threaded)
+        return copied;
+
+    if (!atomic_load_explicit(&r->running, memory_order_acquire) &&
+        !reader_ready(r, tail) && !reconnect_pending(uart)) {
+        error_code(UART_ERR_IO, "reader thread stopped");
+        return -1;
+    }
+
+    return 0;
+}
+
+int reader_peek(struct _uart *uart, char **data, int *len)
+{
+    struct reader *r = uart->reader;
+    unsigned int tail;
+    unsigned int idx;
+
+    tail = atomic_load_explicit(&r->tail, memory_order_relaxed);
+
+    if (!reader_ready(r, tail)) {
+        (*data) = NULL;
+        (*len) = 0;
+
+        if (r->threaded &&
+            !atomic_load_explicit(&r->running, memory_order_acquire) &&
+            !reader_ready(r, tail) && !reconnect_pending(uart)) {
+            error_code(UART_ERR_IO, "reader thread stopped");
+            return -1;
+        }
+
+        return 0;
+    }
+
+    idx = tail & r->mask;
+    (*data) = r->pool + (size_t) idx * r->chunk_size + r->pos;
+    (*len) = r->len[idx] - r->pos;
+    return 0;
+}
+
+int reader_release(struct _uart *uart)
+{
+    struct reader *r = uart->reader;
+    unsigned int tail;
+
+    tail = atomic_load_explicit(&r->tail, memory_order_relaxed);
+
+    if (!reader_ready(r, tail)) {
+        error_code(UART_ERR_STATE, "no chunk to release");
+        return -1;
+    }
+
+    r->pos = 0;
+    atomic_store_explicit(&r->tail, tail + 1, memory_order_release);
+    return 0;
+}
@@ -0,0 +1,72 @@
+/**
+ *
+ * File Name: unix/reader.h
+ * Title    : UNIX UART reader thread
+ * Project  : libUART
+ * Author   : Copyright (C) 2018-2020 Johannes Krottmayer <krjdev@gmail.com>
+ * Created  : 2026-10-19
+ * Modified :
+ * Revised  :
+ * Version  : 0.1.0.0
+ * License  : ISC (see file LICENSE.txt)
+ *
+ * NOTE: This code is currently below version 1.0, and therefore is considered
+ * to be lacking in some functionality or documentation, or may not be fully
+ * tested. Nonetheless, you can expect most functions to work.
+ *
+ */
+
+#ifndef LIBUART_UNIX_READER_H
+#define LIBUART_UNIX_READER_H
+
+#include <pthread.h>
+#include <stdatomic.h>
+
+#include "../util.h"
+
+/* ring geometry used when the ring is filled by libUART_on_readable() */
+#define READER_CHUNK_SIZE   256
+#define READER_CHUNKS       64
+
+struct _uart;
+struct uart_rx_ts;
+
+/*
+ * Single-producer/single-consumer ring of pooled receive chunks.
+ * The producer (the reader thread, or the caller of reader_fill() in
+ * event-loop mode) is the only writer of 'head', the consumer the
+ * only writer of 'tail'. Both indices live on their own cache line
+ * together with a private copy of the other side's index, so the
+ * fast path touches shared memory only when the cached copy says
+ * the ring is full or empty.
+ */
+struct reader {
+    _Alignas(CACHE_LINE_SIZE) atomic_uint head;
+    unsigned int tail_cache;
+    _Alignas(CACHE_LINE_SIZE) atomic_uint tail;
+    unsigned int head_cache;
+    unsigned int pos;
+    _Alignas(CACHE_LINE_SIZE) struct _uart *uart;
+    unsigned int mask;
+    int chunk_size;
+    int *len;
+    struct uart_rx_ts *ts;      /* receive times of each chunk */
+    char *pool;
+    int threaded;
+    int stop_fd[2];
+    atomic_int running;
+    pthread_t thread;
+};
+
+extern int reader_create(struct _uart *uart, int chunk_size, int chunks);
+extern int reader_start(struct _uart *uart, int chunk_size, int chunks);
+extern void reader_stop(struct _uart *uart);
+extern int reader_resume(struct _uart *uart);
+extern int reader_fill(struct _uart *uart);
+extern int reader_full(struct _uart *uart);
+extern int reader_recv(struct _uart *uart, char *recv_buf, int len,
+                       struct uart_rx_ts *ts);
+extern int reader_peek(struct _uart *uart, char **data, int *len);
+extern int reader_release(struct _uart *uart);
+
+#endif
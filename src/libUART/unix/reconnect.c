@@ -0,0 +1,244 @@
+/**
+ *
+ * File Name: unix/reconnect.c
+ * Title    : UNIX UART automatic reconnect
+ * Project  : libUART
+ * Author   : Copyright (C) 2018-2020 Johannes Krottmayer <krjdev@gmail.com>
+ * Created  : 2026-10-19
+ * Modified :
+ * Revised  :
+ * Version  : 0.1.0.0
+ * License  : ISC (see file LICENSE.txt)
+ *
+ * NOTE: This code is currently below version 1.0, and therefore is considered
+ * to be lacking in some functionality or documentation, or may not be fully
+ * tested. Nonetheless, you can expect most functions to work.
+ *
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <time.h>
+
+#include "error.h"
+#include "stats.h"
+#include "reconnect.h"
+
+/*
+ * One thread retries all lost ports. It sleeps until the earliest attempt
+ * is due and reopens the port without holding the lock, so I/O calls that
+ * notice a lost device never wait for an open() of another port.
+ */
+static pthread_once_t g_once = PTHREAD_ONCE_INIT;
+static pthread_mutex_t g_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t g_cond;
+static struct reconnect *g_list;
+static int g_started;
+static int g_errno;
+
+static void reconnect_unlink(struct reconnect *rc)
+{
+    struct reconnect **pp;
+
+    for (pp = &g_list; (*pp); pp = &(*pp)->next) {
+        if ((*pp) == rc) {
+            (*pp) = rc->next;
+            break;
+        }
+    }
+
+    rc->queued = 0;
+}
+
+static void reconnect_wait(long long due_ns)
+{
+    struct timespec ts;
+
+    ts.tv_sec = due_ns / 1000000000LL;
+    ts.tv_nsec = due_ns % 1000000000LL;
+    pthread_cond_timedwait(&g_cond, &g_lock, &ts);
+}
+
+static void *reconnect_thread(void *arg)
+{
+    struct reconnect *rc;
+    struct reconnect *due;
+    long long now;
+    int ret;
+
+    (void) arg;
+    pthread_mutex_lock(&g_lock);
+
+    while (1) {
+        due = NULL;
+
+        for (rc = g_list; rc; rc = rc->next) {
+            if (!rc->busy && (!due || rc->due_ns < due->due_ns))
+                due = rc;
+        }
+
+        if (!due) {
+            pthread_cond_wait(&g_cond, &g_lock);
+            continue;
+        }
+
+        /* reopened in the meantime, e.g. by the hotplug monitor */
+        if (!atomic_load(&due->lost)) {
+            reconnect_unlink(due);
+            continue;
+        }
+
+        now = stats_now_ns();
+
+        if (due->due_ns > now) {
+            reconnect_wait(due->due_ns);
+            continue;
+        }
+
+        due->busy = 1;
+        pthread_mutex_unlock(&g_lock);
+        ret = uart_reopen(due->uart);
+        pthread_mutex_lock(&g_lock);
+        due->busy = 0;
+
+        if (ret == 0) {
+            reconnect_unlink(due);
+        } else {
+            due->delay_ms *= 2;
+
+            if (due->delay_ms > due->max_ms)
+                due->delay_ms = due->max_ms;
+
+            due->due_ns = stats_now_ns() + due->delay_ms * 1000000LL;
+        }
+
+        /* reconnect_disable() may wait for the attempt to finish */
+        pthread_cond_broadcast(&g_cond);
+    }
+
+    return NULL;
+}
+
+static void reconnect_start(void)
+{
+    pthread_condattr_t attr;
+    pthread_t thread;
+    int ret;
+
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(&g_cond, &attr);
+    pthread_condattr_destroy(&attr);
+    ret = pthread_create(&thread, NULL, reconnect_thread, NULL);
+
+    if (ret != 0) {
+        g_errno = ret;
+        return;
+    }
+
+    pthread_detach(thread);
+    g_started = 1;
+}
+
+int reconnect_enable(struct _uart *uart, int min_ms, int max_ms)
+{
+    struct reconnect *rc;
+
+    pthread_once(&g_once, reconnect_start);
+
+    if (!g_started) {
+        errno = g_errno;
+        error("pthread_create() failed", 1);
+        return -1;
+    }
+
+    pthread_mutex_lock(&g_lock);
+    rc = uart->rc;
+
+    if (!rc) {
+        rc = (struct reconnect *) calloc(1, sizeof(*rc));
+
+        if (!rc) {
+            pthread_mutex_unlock(&g_lock);
+            error("calloc() failed", 1);
+            return -1;
+        }
+
+        rc->uart = uart;
+        atomic_init(&rc->enabled, 0);
+        atomic_init(&rc->lost, 0);
+        uart->rc = rc;
+    }
+
+    rc->min_ms = min_ms;
+    rc->max_ms = max_ms;
+    atomic_store(&rc->enabled, 1);
+    pthread_mutex_unlock(&g_lock);
+    return 0;
+}
+
+/*
+ * The reader thread or a pool worker may still report a lost device, so
+ * the state is only freed by reconnect_destroy() when the port is closed.
+ */
+void reconnect_disable(struct _uart *uart)
+{
+    struct reconnect *rc = uart->rc;
+
+    pthread_mutex_lock(&g_lock);
+    atomic_store(&rc->enabled, 0);
+
+    while (rc->busy)
+        pthread_cond_wait(&g_cond, &g_lock);
+
+    if (rc->queued)
+        reconnect_unlink(rc);
+
+    atomic_store(&rc->lost, 0);
+    pthread_mutex_unlock(&g_lock);
+}
+
+void reconnect_destroy(struct _uart *uart)
+{
+    reconnect_disable(uart);
+    free(uart->rc);
+    uart->rc = NULL;
+}
+
+/*
+ * Called by the I/O paths when the device of the port went away. Returns
+ * 1 if the port waits for a reconnect, 0 if reconnecting is disabled.
+ */
+int reconnect_lost(struct _uart *uart)
+{
+    struct reconnect *rc = uart->rc;
+
+    if (!atomic_load(&rc->enabled))
+        return 0;
+
+    if (atomic_exchange(&rc->lost, 1))
+        return 1;
+
+    pthread_mutex_lock(&g_lock);
+
+    /* disabled while we were taking the lock */
+    if (!atomic_load(&rc->enabled)) {
+        atomic_store(&rc->lost, 0);
+        pthread_mutex_unlock(&g_lock);
+        return 0;
+    }
+
+    rc->delay_ms = rc->min_ms;
+    rc->due_ns = stats_now_ns() + rc->min_ms * 1000000LL;
+
+    if (!rc->queued) {
+        rc->next = g_list;
+        g_list = rc;
+        rc->queued = 1;
+    }
+
+    pthread_cond_broadcast(&g_cond);
+    pthread_mutex_unlock(&g_lock);
+    return 1;
+}
@@ -0,0 +1,55 @@
+/**
+ *
+ * File Name: unix/reconnect.h
+ * Title    : UNIX UART automatic reconnect
+ * Project  : libUART
+ * Author   : Copyright (C) 2018-2020 Johannes Krottmayer <krjdev@gmail.com>
+ * Created  : 2026-10-19
+ * Modified :
+ * Revised  :
+ * Version  : 0.1.0.0
+ * License  : ISC (see file LICENSE.txt)
+ *
+ * NOTE: This code is currently below version 1.0, and therefore is considered
+ * to be lacking in some functionality or documentation, or may not be fully
+ * tested. Nonetheless, you can expect most functions to work.
+ *
+ */
+
+#ifndef LIBUART_UNIX_RECONNECT_H
+#define LIBUART_UNIX_RECONNECT_H
+
+#include <errno.h>
+#include <stdatomic.h>
+
+#include "uart.h"
+
+/* errors of a descriptor whose device went away */
+#define RECONNECT_ERRNO(e)  ((e) == EIO || (e) == ENXIO || (e) == ENODEV)
+
+struct reconnect {
+    struct _uart *uart;
+    atomic_int enabled;
+    atomic_int lost;            /* device gone, waiting for the reopen */
+    int min_ms;                 /* first retry delay */
+    int max_ms;                 /* upper bound of the doubled delay */
+    int delay_ms;
+    long long due_ns;           /* time of the next attempt */
+    int queued;                 /* on the retry list */
+    int busy;                   /* being reopened by the retry thread */
+    struct reconnect *next;
+};
+
+extern int reconnect_enable(struct _uart *uart, int min_ms, int max_ms);
+extern void reconnect_disable(struct _uart *uart);
+extern void reconnect_destroy(struct _uart *uart);
+extern int reconnect_lost(struct _uart *uart);
+
+/* returns 1 while the port waits for its device to come back */
+static inline int reconnect_pending(struct _uart *uart)
+{
+    return uart->rc &&
+           atomic_load_explicit(&uart->rc->lost, memory_order_acquire);
+}
+
+#endif
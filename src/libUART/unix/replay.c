@@ -0,0 +1,395 @@
+/**
+ *
+ * File Name: unix/replay.c
+ * Title    : UNIX UART capture replay
+ * Project  : libUART
+ * Author   : Copyright (C) 2018-2020 Johannes Krottmayer <krjdev@gmail.com>
+ * Created  : 2026-10-19
+ * Modified :
+ * Revised  :
+ * Version  : 0.1.0.0
+ * License  : ISC (see file LICENSE.txt)
+ *
+ * NOTE: This code is currently below version 1.0, and therefore is considered
+ * to be lacking in some functionality or documentation, or may not be fully
+ * tested. Nonetheless, you can expect most functions to work.
+ *
+ */
+
+/* ppoll() */
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "error.h"
+#include "stats.h"
+#include "capture.h"
+#include "sim.h"
+#include "replay.h"
+
+#define REPLAY_BUF_SIZE     4096
+
+struct replay_seg {
+    uint64_t seq;
+    char *map;
+    size_t size;
+};
+
+static int replay_seg_cmp(const void *a, const void *b)
+{
+    const struct replay_seg *x = (const struct replay_seg *) a;
+    const struct replay_seg *y = (const struct replay_seg *) b;
+
+    return x->seq < y->seq ? -1 : (x->seq > y->seq);
+}
+
+static char *replay_map(const char *path, int idx, size_t *size)
+{
+    char name[DEV_NAME_LEN + 16];
+    struct stat st;
+    char *map;
+    int fd;
+
+    snprintf(name, sizeof(name), "%s.%d", path, idx);
+    fd = open(name, O_RDONLY);
+
+    if (fd == -1)
+        return NULL;
+
+    if (fstat(fd, &st) == -1 || (size_t) st.st_size < CAP_HDR_SIZE) {
+        close(fd);
+        return MAP_FAILED;
+    }
+
+    map = (char *) mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    (*size) = st.st_size;
+    return map;
+}
+
+/* walk the records of all segments, oldest first */
+static void replay_walk(struct replay *rp, struct replay_seg *seg, int n,
+                        int copy)
+{
+    const struct cap_rec *rec;
+    const struct cap_seg *hdr;
+    size_t end;
+    size_t off;
+    int i;
+
+    rp->chunks = 0;
+    rp->rx_total = 0;
+    rp->tx_total = 0;
+
+    for (i = 0; i < n; i++) {
+        hdr = (const struct cap_seg *) seg[i].map;
+        end = hdr->used < seg[i].size ? hdr->used : seg[i].size;
+
+        for (off = CAP_HDR_SIZE; off + sizeof(*rec) <= end;
+             off += CAP_PAD(sizeof(*rec) + rec->len)) {
+            rec = (const struct cap_rec *) (seg[i].map + off);
+
+            if (off + sizeof(*rec) + rec->len > end)
+                break;
+
+            if (rec->dir == CAP_RX) {
+                if (copy) {
+                    rp->chunk[rp->chunks].ts_ns = rec->ts_ns;
+                    rp->chunk[rp->chunks].off = rp->rx_total;
+                    rp->chunk[rp->chunks].len = rec->len;
+                    memcpy(rp->rx + rp->rx_total, rec + 1, rec->len);
+                }
+
+                rp->chunks++;
+                rp->rx_total += rec->len;
+            } else {
+                if (copy)
+                    memcpy(rp->tx + rp->tx_total, rec + 1, rec->len);
+
+                rp->tx_total += rec->len;
+            }
+        }
+    }
+}
+
+static int replay_load(struct replay *rp, const char *path)
+{
+    struct replay_seg *seg = NULL;
+    struct replay_seg *tmp;
+    size_t size;
+    char *map;
+    int ret = -1;
+    int n = 0;
+    int i;
+
+    for (i = 0; (map = replay_map(path, i, &size)); i++) {
+        if (map == MAP_FAILED)
+            continue;
+
+        if (((struct cap_seg *) map)->magic != CAP_MAGIC ||
+            ((struct cap_seg *) map)->version != CAP_VERSION) {
+            munmap(map, size);
+            continue;
+        }
+
+        tmp = (struct replay_seg *) realloc(seg, (n + 1) * sizeof(*seg));
+
+        if (!tmp) {
+            error("realloc() failed", 1);
+            munmap(map, size);
+            goto out;
+        }
+
+        seg = tmp;
+        seg[n].seq = ((struct cap_seg *) map)->seq;
+        seg[n].map = map;
+        seg[n].size = size;
+        n++;
+    }
+
+    if (n == 0) {
+        error_code(UART_ERR_INVAL, "no capture segments found");
+        goto out;
+    }
+
+    qsort(seg, n, sizeof(*seg), replay_seg_cmp);
+    replay_walk(rp, seg, n, 0);
+    rp->chunk = (struct replay_chunk *) malloc((rp->chunks + 1) *
+                                               sizeof(*rp->chunk));
+    rp->rx = (char *) malloc(rp->rx_total + 1);
+    rp->tx = (char *) malloc(rp->tx_total + 1);
+
+    if (!rp->chunk || !rp->rx || !rp->tx) {
+        error("malloc() failed", 1);
+        goto out;
+    }
+
+    replay_walk(rp, seg, n, 1);
+    ret = 0;
+
+out:
+    for (i = 0; i < n; i++)
+        munmap(seg[i].map, seg[i].size);
+
+    free(seg);
+    return ret;
+}
+
+static void replay_compare(struct replay *rp, const char *buf, int len)
+{
+    unsigned long long pos;
+    unsigned long long bad = 0;
+    long long first = -1;
+    int i;
+
+    pos = atomic_load_explicit(&rp->tx_bytes, memory_order_relaxed);
+
+    for (i = 0; i < len; i++, pos++) {
+        if (pos < rp->tx_total && rp->tx[pos] == buf[i])
+            continue;
+
+        if (first == -1)
+            first = pos;
+
+        bad++;
+    }
+
+    if (bad) {
+        atomic_fetch_add(&rp->tx_mismatch, bad);
+
+        if (atomic_load(&rp->tx_first) == -1)
+            atomic_store(&rp->tx_first, first);
+    }
+
+    atomic_fetch_add(&rp->tx_bytes, len);
+}
+
+static void *replay_thread(void *arg)
+{
+    struct replay *rp = (struct replay *) arg;
+    char buf[REPLAY_BUF_SIZE];
+    struct replay_chunk *c;
+    struct pollfd pfd[2];
+    struct timespec ts;
+    long long start;
+    long long wake;
+    long long due;
+    long long now;
+    size_t idx = 0;
+    size_t woff = 0;
+    int blocked;
+    int ret;
+
+    pfd[0].fd = rp->master;
+    pfd[1].fd = rp->stop_fd[0];
+    pfd[1].events = POLLIN;
+    start = stats_now_ns();
+
+    while (1) {
+        now = stats_now_ns();
+        wake = -1;
+        blocked = 0;
+
+        while (idx < rp->chunks) {
+            c = &rp->chunk[idx];
+            due = rp->speed > 0.0 ?
+                  start + (long long) ((c->ts_ns - rp->chunk[0].ts_ns) /
+                                       rp->speed) : 0;
+
+            if (due > now) {
+                wake = due - now;
+                break;
+            }
+
+            ret = write(rp->master, rp->rx + c->off + woff, c->len - woff);
+
+            if (ret == -1) {
+                blocked = 1;
+                break;
+            }
+
+            woff += ret;
+            atomic_fetch_add(&rp->rx_bytes, ret);
+
+            if (woff == c->len) {
+                woff = 0;
+                idx++;
+            }
+        }
+
+        if (idx == rp->chunks)
+            atomic_store(&rp->done, 1);
+
+        pfd[0].events = POLLIN | (blocked ? POLLOUT : 0);
+
+        if (wake != -1) {
+            ts.tv_sec = wake / 1000000000LL;
+            ts.tv_nsec = wake % 1000000000LL;
+        }
+
+        ret = ppoll(pfd, 2, wake == -1 ? NULL : &ts, NULL);
+
+        if (ret == -1) {
+            if (errno == EINTR)
+                continue;
+
+            error("ppoll() failed", 1);
+            break;
+        }
+
+        if (pfd[1].revents)
+            break;
+
+        if (pfd[0].revents & POLLIN) {
+            ret = read(rp->master, buf, sizeof(buf));
+
+            if (ret > 0 && rp->compare)
+                replay_compare(rp, buf, ret);
+            else if (ret > 0)
+                atomic_fetch_add(&rp->tx_bytes, ret);
+        }
+    }
+
+    return NULL;
+}
+
+struct replay *replay_create(const char *path, double speed, int compare)
+{
+    struct replay *rp;
+
+    rp = (struct replay *) calloc(1, sizeof(*rp));
+
+    if (!rp) {
+        error("calloc() failed", 1);
+        return NULL;
+    }
+
+    rp->master = -1;
+    rp->slave = -1;
+    rp->speed = speed;
+    rp->compare = compare;
+    atomic_init(&rp->rx_bytes, 0);
+    atomic_init(&rp->tx_bytes, 0);
+    atomic_init(&rp->tx_mismatch, 0);
+    atomic_init(&rp->tx_first, -1);
+    atomic_init(&rp->done, 0);
+
+    if (replay_load(rp, path) == -1 ||
+        sim_pty(&rp->master, &rp->slave, rp->dev) == -1) {
+        replay_destroy(rp);
+        return NULL;
+    }
+
+    return rp;
+}
+
+int replay_start(struct _uart *uart, struct replay *rp)
+{
+    int ret;
+
+    if (pipe(rp->stop_fd) == -1) {
+        error("pipe() failed", 1);
+        return -1;
+    }
+
+    ret = pthread_create(&rp->thread, NULL, replay_thread, rp);
+
+    if (ret != 0) {
+        errno = ret;
+        error("pthread_create() failed", 1);
+        close(rp->stop_fd[0]);
+        close(rp->stop_fd[1]);
+        return -1;
+    }
+
+    rp->running = 1;
+    uart->replay = rp;
+    return 0;
+}
+
+void replay_destroy(struct replay *rp)
+{
+    char c = 0;
+
+    if (rp->running) {
+        if (write(rp->stop_fd[1], &c, 1) == -1)
+            error("write() failed", 1);
+
+        pthread_join(rp->thread, NULL);
+        close(rp->stop_fd[0]);
+        close(rp->stop_fd[1]);
+    }
+
+    if (rp->slave != -1)
+        close(rp->slave);
+
+    if (rp->master != -1)
+        close(rp->master);
+
+    free(rp->chunk);
+    free(rp->rx);
+    free(rp->tx);
+    free(rp);
+}
+
+void replay_get(struct _uart *uart, struct uart_replay_stats *stats)
+{
+    struct replay *rp = uart->replay;
+
+    stats->rx_bytes = atomic_load(&rp->rx_bytes);
+    stats->rx_total = rp->rx_total;
+    stats->tx_bytes = atomic_load(&rp->tx_bytes);
+    stats->tx_total = rp->tx_total;
+    stats->tx_mismatch = atomic_load(&rp->tx_mismatch);
+    stats->tx_first_mismatch = atomic_load(&rp->tx_first);
+    stats->done = atomic_load(&rp->done);
+}
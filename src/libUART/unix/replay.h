@@ -0,0 +1,69 @@
+/**
+ *
+ * File Name: unix/replay.h
+ * Title    : UNIX UART capture replay
+ * Project  : libUART
+ * Author   : Copyright (C) 2018-2020 Johannes Krottmayer <krjdev@gmail.com>
+ * Created  : 2026-10-19
+ * Modified :
+ * Revised  :
+ * Version  : 0.1.0.0
+ * License  : ISC (see file LICENSE.txt)
+ *
+ * NOTE: This code is currently below version 1.0, and therefore is considered
+ * to be lacking in some functionality or documentation, or may not be fully
+ * tested. Nonetheless, you can expect most functions to work.
+ *
+ */
+
+#ifndef LIBUART_UNIX_REPLAY_H
+#define LIBUART_UNIX_REPLAY_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include <pthread.h>
+
+#include "../libUART.h"
+#include "uart.h"
+
+struct replay_chunk {
+    int64_t ts_ns;
+    size_t off;
+    size_t len;
+};
+
+/*
+ * A capture loaded into memory and served through a pseudo terminal.
+ * The feeder thread writes the received chunks to the master at their
+ * (scaled) original time and reads back what the application sends.
+ */
+struct replay {
+    int master;
+    int slave;
+    char dev[DEV_NAME_LEN];
+    double speed;
+    int compare;
+    char *rx;
+    struct replay_chunk *chunk;
+    size_t chunks;
+    size_t rx_total;
+    char *tx;
+    size_t tx_total;
+    atomic_ullong rx_bytes;
+    atomic_ullong tx_bytes;
+    atomic_ullong tx_mismatch;
+    atomic_llong tx_first;
+    atomic_int done;
+    int stop_fd[2];
+    int running;
+    pthread_t thread;
+};
+
+extern struct replay *replay_create(const char *path, double speed,
+                                    int compare);
+extern int replay_start(struct _uart *uart, struct replay *rp);
+extern void replay_destroy(struct replay *rp);
+extern void replay_get(struct _uart *uart, struct uart_replay_stats *stats);
+
+#endif
@@ -0,0 +1,399 @@
+/**
+ *
+ * File Name: unix/share.c
+ * Title    : UNIX UART port sharing over pseudo terminals
+ * Project  : libUART
+ * Author   : Copyright (C) 2018-2020 Johannes Krottmayer <krjdev@gmail.com>
+ * Created  : 2026-10-19
+ * Modified :
+ * Revised  :
+ * Version  : 0.1.0.0
+ * License  : ISC (see file LICENSE.txt)
+ *
+ * NOTE: This code is currently below version 1.0, and therefore is considered
+ * to be lacking in some functionality or documentation, or may not be fully
+ * tested. Nonetheless, you can expect most functions to work.
+ *
+ */
+
+/* ptsname_r() */
+#define _GNU_SOURCE
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include <termios.h>
+#include <sys/eventfd.h>
+#include <sys/uio.h>
+
+#include "error.h"
+#include "reconnect.h"
+#include "share.h"
+
+/* hand received data to every pty, a pty that does not keep up loses it */
+static void share_rx(struct _uart_share *sh, const char *buf, int len)
+{
+    struct share_pty *p;
+    int n;
+    int i;
+
+    for (i = 0; i < sh->num; i++) {
+        p = &sh->pty[i];
+        n = 0;
+
+        if (p->rx_len == 0) {
+            n = write(p->master, buf, len);
+
+            if (n == -1)
+                n = 0;
+        }
+
+        if (n == len)
+            continue;
+
+        if (p->rx_off > 0 && p->rx_off + p->rx_len + len - n > SHARE_RX_SIZE) {
+            memmove(p->rx, p->rx + p->rx_off, p->rx_len);
+            p->rx_off = 0;
+        }
+
+        if (p->rx_off + p->rx_len + len - n > SHARE_RX_SIZE) {
+            p->dropped += len - n;
+            continue;
+        }
+
+        memcpy(p->rx + p->rx_off + p->rx_len, buf + n, len - n);
+        p->rx_len += len - n;
+    }
+}
+
+static void share_rx_flush(struct share_pty *p)
+{
+    int n;
+
+    n = write(p->master, p->rx + p->rx_off, p->rx_len);
+
+    if (n <= 0)
+        return;
+
+    p->rx_off += n;
+    p->rx_len -= n;
+
+    if (p->rx_len == 0)
+        p->rx_off = 0;
+}
+
+/*
+ * A complete line or frame waits for the port. A pty does not keep the
+ * write() boundaries of its client, so a frame is what one read() of the
+ * master returned: a write may arrive split or merged with the next one.
+ */
+static void share_unit(struct _uart_share *sh, struct share_pty *p)
+{
+    char *nl;
+    int i;
+
+    if (p->tx_unit > 0 || p->tx_len == 0)
+        return;
+
+    if (sh->mode == UART_SHARE_FRAME) {
+        p->tx_unit = p->tx_len;
+        return;
+    }
+
+    for (nl = NULL, i = p->tx_len - 1; i >= 0; i--) {
+        if (p->tx[i] == '\n') {
+            nl = p->tx + i;
+            break;
+        }
+    }
+
+    /* an overlong line goes out in pieces */
+    if (nl)
+        p->tx_unit = nl - p->tx + 1;
+    else if (p->tx_len == SHARE_TX_SIZE)
+        p->tx_unit = p->tx_len;
+}
+
+static void share_tx_read(struct _uart_share *sh, struct share_pty *p)
+{
+    int n;
+
+    n = read(p->master, p->tx + p->tx_len, SHARE_TX_SIZE - p->tx_len);
+
+    if (n <= 0)
+        return;
+
+    p->tx_len += n;
+    share_unit(sh, p);
+}
+
+/* pick the next pty with a complete unit, round robin */
+static void share_pick(struct _uart_share *sh)
+{
+    int i;
+    int k;
+
+    if (sh->owner != -1)
+        return;
+
+    for (i = 0; i < sh->num; i++) {
+        k = (sh->next + i) % sh->num;
+
+        if (sh->pty[k].tx_unit > 0) {
+            sh->owner = k;
+            sh->next = (k + 1) % sh->num;
+            return;
+        }
+    }
+}
+
+/* send the unit of the owner, returns -1 on errors */
+static int share_tx(struct _uart_share *sh)
+{
+    struct share_pty *p;
+    struct iovec iov;
+    int ret;
+
+    while (sh->owner != -1) {
+        p = &sh->pty[sh->owner];
+        iov.iov_base = p->tx + p->tx_off;
+        iov.iov_len = p->tx_unit - p->tx_off;
+        ret = uart_sendv(sh->uart, &iov, 1);
+
+        if (ret == -1)
+            return -1;
+
+        /* port busy or reconnecting */
+        if (ret == 0)
+            return 0;
+
+        p->tx_off += ret;
+
+        if (p->tx_off < p->tx_unit)
+            continue;
+
+        memmove(p->tx, p->tx + p->tx_unit, p->tx_len - p->tx_unit);
+        p->tx_len -= p->tx_unit;
+        p->tx_unit = 0;
+        p->tx_off = 0;
+        share_unit(sh, p);
+        sh->owner = -1;
+        share_pick(sh);
+    }
+
+    return 0;
+}
+
+static void *share_thread(void *arg)
+{
+    struct _uart_share *sh = (struct _uart_share *) arg;
+    struct pollfd pfd[2 + SHARE_MAX_PTYS];
+    struct share_pty *p;
+    char buf[SHARE_BUF_SIZE];
+    int paused = 0;
+    int ret;
+    int i;
+
+    pfd[0].fd = sh->stop_fd;
+    pfd[0].events = POLLIN;
+
+    while (1) {
+        if (paused && !reconnect_pending(sh->uart))
+            paused = 0;
+
+        pfd[1].fd = paused ? -1 : sh->uart->fd;
+        pfd[1].events = POLLIN | (sh->owner != -1 ? POLLOUT : 0);
+
+        for (i = 0; i < sh->num; i++) {
+            p = &sh->pty[i];
+            pfd[2 + i].fd = p->master;
+            pfd[2 + i].events = 0;
+
+            /* a pty waits until its unit is sent */
+            if (p->tx_unit == 0 && p->tx_len < SHARE_TX_SIZE)
+                pfd[2 + i].events |= POLLIN;
+
+            if (p->rx_len > 0)
+                pfd[2 + i].events |= POLLOUT;
+        }
+
+        ret = poll(pfd, 2 + sh->num, paused ? SHARE_POLL_MS : -1);
+
+        if (ret == -1) {
+            if (errno == EINTR)
+                continue;
+
+            error("poll() failed", 1);
+            break;
+        }
+
+        if (pfd[0].revents)
+            break;
+
+        if (pfd[1].revents & (POLLIN | POLLHUP | POLLERR)) {
+            ret = uart_recv(sh->uart, buf, sizeof(buf));
+
+            if (ret > 0) {
+                share_rx(sh, buf, ret);
+            } else if (ret == -1 || (pfd[1].revents & (POLLHUP | POLLERR))) {
+                /* a hung up tty reads as end of file */
+                if (reconnect_pending(sh->uart) ||
+                    (sh->uart->rc && reconnect_lost(sh->uart))) {
+                    paused = 1;
+                } else {
+                    error_code(UART_ERR_IO, "UART device hung up");
+                    break;
+                }
+            }
+        }
+
+        for (i = 0; i < sh->num; i++) {
+            p = &sh->pty[i];
+
+            if (pfd[2 + i].revents & POLLOUT)
+                share_rx_flush(p);
+
+            if (pfd[2 + i].revents & POLLIN)
+                share_tx_read(sh, p);
+        }
+
+        share_pick(sh);
+
+        if (!paused && share_tx(sh) == -1)
+            break;
+    }
+
+    return NULL;
+}
+
+static int share_open_pty(struct share_pty *p)
+{
+    struct termios options;
+
+    p->master = posix_openpt(O_RDWR | O_NOCTTY | O_NONBLOCK | O_CLOEXEC);
+
+    if (p->master == -1) {
+        error("posix_openpt() failed", 1);
+        return -1;
+    }
+
+    if (grantpt(p->master) == -1 || unlockpt(p->master) == -1 ||
+        ptsname_r(p->master, p->name, sizeof(p->name)) != 0) {
+        error("unlockpt() failed", 1);
+        return -1;
+    }
+
+    p->slave = open(p->name, O_RDWR | O_NOCTTY | O_NONBLOCK | O_CLOEXEC);
+
+    if (p->slave == -1) {
+        error("open() failed", 1);
+        return -1;
+    }
+
+    /* pass the data through unchanged until a client sets up the pty */
+    if (tcgetattr(p->slave, &options) == 0) {
+        cfmakeraw(&options);
+        tcsetattr(p->slave, TCSANOW, &options);
+    }
+
+    p->rx = (char *) malloc(SHARE_RX_SIZE);
+    p->tx = (char *) malloc(SHARE_TX_SIZE);
+
+    if (!p->rx || !p->tx) {
+        error("malloc() failed", 1);
+        return -1;
+    }
+
+    return 0;
+}
+
+static void share_free(struct _uart_share *sh)
+{
+    struct share_pty *p;
+    int i;
+
+    for (i = 0; i < sh->num; i++) {
+        p = &sh->pty[i];
+
+        if (p->slave != -1)
+            close(p->slave);
+
+        if (p->master != -1)
+            close(p->master);
+
+        free(p->rx);
+        free(p->tx);
+    }
+
+    if (sh->stop_fd != -1)
+        close(sh->stop_fd);
+
+    free(sh);
+}
+
+struct _uart_share *share_create(struct _uart *uart, int num, int mode)
+{
+    struct _uart_share *sh;
+    int ret;
+    int i;
+
+    sh = (struct _uart_share *) calloc(1, sizeof(*sh) +
+                                       num * sizeof(struct share_pty));
+
+    if (!sh) {
+        error("calloc() failed", 1);
+        return NULL;
+    }
+
+    sh->uart = uart;
+    sh->mode = mode;
+    sh->owner = -1;
+    sh->num = num;
+
+    for (i = 0; i < num; i++) {
+        sh->pty[i].master = -1;
+        sh->pty[i].slave = -1;
+    }
+
+    sh->stop_fd = eventfd(0, EFD_CLOEXEC);
+
+    if (sh->stop_fd == -1) {
+        error("eventfd() failed", 1);
+        share_free(sh);
+        return NULL;
+    }
+
+    for (i = 0; i < num; i++) {
+        if (share_open_pty(&sh->pty[i]) == -1) {
+            share_free(sh);
+            return NULL;
+        }
+    }
+
+    ret = pthread_create(&sh->thread, NULL, share_thread, sh);
+
+    if (ret != 0) {
+        errno = ret;
+        error("pthread_create() failed", 1);
+        share_free(sh);
+        return NULL;
+    }
+
+    uart->share = sh;
+    return sh;
+}
+
+void share_destroy(struct _uart_share *sh)
+{
+    uint64_t one = 1;
+
+    if (write(sh->stop_fd, &one, sizeof(one)) == -1)
+        error("write() failed", 1);
+
+    pthread_join(sh->thread, NULL);
+    sh->uart->share = NULL;
+    share_free(sh);
+}
@@ -0,0 +1,64 @@
+/**
+ *
+ * File Name: unix/share.h
+ * Title    : UNIX UART port sharing over pseudo terminals
+ * Project  : libUART
+ * Author   : Copyright (C) 2018-2020 Johannes Krottmayer <krjdev@gmail.com>
+ * Created  : 2026-10-19
+ * Modified :
+ * Revised  :
+ * Version  : 0.1.0.0
+ * License  : ISC (see file LICENSE.txt)
+ *
+ * NOTE: This code is currently below version 1.0, and therefore is considered
+ * to be lacking in some functionality or documentation, or may not be fully
+ * tested. Nonetheless, you can expect most functions to work.
+ *
+ */
+
+#ifndef LIBUART_UNIX_SHARE_H
+#define LIBUART_UNIX_SHARE_H
+
+#include <pthread.h>
+
+#include "../libUART.h"
+#include "uart.h"
+
+#define SHARE_MAX_PTYS      32
+/* received data kept for a pty whose reader is slow */
+#define SHARE_RX_SIZE       65536
+/* longest line or frame sent in one piece */
+#define SHARE_TX_SIZE       4096
+#define SHARE_BUF_SIZE      4096
+/* polling interval while the port reconnects */
+#define SHARE_POLL_MS       100
+
+struct share_pty {
+    int master;
+    int slave;                  /* kept open, the master never hangs up */
+    char name[64];
+    char *rx;                   /* data for the pty, not written yet */
+    int rx_off;
+    int rx_len;
+    char *tx;                   /* data from the pty */
+    int tx_len;
+    int tx_unit;                /* length of the complete line or frame */
+    int tx_off;                 /* bytes of the unit already sent */
+    unsigned long long dropped;
+};
+
+struct _uart_share {
+    struct _uart *uart;
+    int mode;
+    int stop_fd;
+    pthread_t thread;
+    int owner;                  /* pty whose unit is being sent, -1 if none */
+    int next;                   /* first pty asked for the next unit */
+    int num;
+    struct share_pty pty[];
+};
+
+extern struct _uart_share *share_create(struct _uart *uart, int num, int mode);
+extern void share_destroy(struct _uart_share *sh);
+
+#endif
@@ -0,0 +1,327 @@
+/**
+ *
+ * File Name: unix/sim.c
+ * Title    : UNIX virtual UART simulator
+ * Project  : libUART
+ * Author   : Copyright (C) 2018-2020 Johannes Krottmayer <krjdev@gmail.com>
+ * Created  : 2026-10-19
+ * Modified :
+ * Revised  :
+ * Version  : 0.1.0.0
+ * License  : ISC (see file LICENSE.txt)
+ *
+ * NOTE: This code is currently below version 1.0, and therefore is considered
+ * to be lacking in some functionality or documentation, or may not be fully
+ * tested. Nonetheless, you can expect most functions to work.
+ *
+ */
+
+/* ppoll(), ptsname_r() */
+#define _GNU_SOURCE
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "error.h"
+#include "stats.h"
+#include "sim.h"
+
+#define SIM_MASK            (SIM_QUEUE_SIZE - 1)
+
+/* retry interval while a receiving end does not take more data */
+#define SIM_BLOCKED_NS      1000000LL
+
+/*
+ * Create a pseudo terminal in raw mode. The slave stays open as well,
+ * the master reports EIO while nobody has it open. Also used by the
+ * replay backend.
+ */
+int sim_pty(int *master, int *slave, char *dev)
+{
+    struct termios options;
+    int fd;
+
+    fd = posix_openpt(O_RDWR | O_NOCTTY);
+
+    if (fd == -1) {
+        error("posix_openpt() failed", 1);
+        return -1;
+    }
+
+    (*master) = fd;
+
+    if (grantpt(fd) == -1 || unlockpt(fd) == -1 ||
+        ptsname_r(fd, dev, DEV_NAME_LEN) != 0) {
+        error("pseudo terminal setup failed", 1);
+        return -1;
+    }
+
+    (*slave) = open(dev, O_RDWR | O_NOCTTY);
+
+    if ((*slave) == -1) {
+        error("open() failed", 1);
+        return -1;
+    }
+
+    /* no echo or line editing until the application configures the end */
+    if (tcgetattr((*slave), &options) == -1) {
+        error("tcgetattr() failed", 1);
+        return -1;
+    }
+
+    cfmakeraw(&options);
+
+    if (tcsetattr((*slave), TCSANOW, &options) == -1) {
+        error("tcsetattr() failed", 1);
+        return -1;
+    }
+
+    if (fcntl(fd, F_SETFL, O_NONBLOCK) == -1) {
+        error("fcntl() failed", 1);
+        return -1;
+    }
+
+    return 0;
+}
+
+/* flip every data bit with the configured probability */
+static unsigned char sim_corrupt(struct _uart_sim *sim, unsigned char c)
+{
+    int i;
+
+    for (i = 0; i < sim->data_bits; i++) {
+        if ((double) rand_r(&sim->seed) / RAND_MAX < sim->cfg.bit_error_rate)
+            c ^= (1 << i);
+    }
+
+    return c;
+}
+
+static long long sim_delay(struct _uart_sim *sim)
+{
+    long long delay = sim->cfg.latency_us * 1000LL;
+
+    if (sim->cfg.jitter_us > 0)
+        delay += (long long) ((double) rand_r(&sim->seed) / RAND_MAX *
+                              sim->cfg.jitter_us * 1000.0);
+
+    return delay;
+}
+
+/* put the bytes on the wire, one character time after the other */
+static void sim_take(struct _uart_sim *sim, struct sim_dir *d)
+{
+    unsigned char buf[SIM_QUEUE_SIZE];
+    unsigned int idx;
+    long long start;
+    long long due;
+    long long now;
+    int space;
+    int ret;
+    int i;
+
+    space = SIM_QUEUE_SIZE - (d->head - d->tail);
+    ret = read(d->in, buf, space);
+
+    if (ret <= 0)
+        return;
+
+    now = stats_now_ns();
+
+    for (i = 0; i < ret; i++) {
+        start = now > d->line_free ? now : d->line_free;
+        d->line_free = start + sim->char_ns;
+        due = d->line_free + sim_delay(sim);
+
+        /* jitter delays bytes, it never reorders them */
+        if (due < d->last_due)
+            due = d->last_due;
+
+        d->last_due = due;
+        idx = d->head & SIM_MASK;
+        d->data[idx] = sim->cfg.bit_error_rate > 0.0 ?
+                       sim_corrupt(sim, buf[i]) : buf[i];
+        d->due[idx] = due;
+        d->head++;
+    }
+}
+
+/* hand the bytes due by now to the receiving end, returns the next due */
+static long long sim_give(struct sim_dir *d, long long now)
+{
+    unsigned char buf[SIM_QUEUE_SIZE];
+    unsigned int t;
+    int n = 0;
+    int ret;
+
+    for (t = d->tail; t != d->head && d->due[t & SIM_MASK] <= now; t++)
+        buf[n++] = d->data[t & SIM_MASK];
+
+    if (n > 0) {
+        ret = write(d->out, buf, n);
+
+        /* receiving end full, try again shortly */
+        if (ret <= 0)
+            return now + SIM_BLOCKED_NS;
+
+        d->tail += ret;
+    }
+
+    if (d->tail == d->head)
+        return -1;
+
+    if (d->due[d->tail & SIM_MASK] <= now)
+        return now + SIM_BLOCKED_NS;
+
+    return d->due[d->tail & SIM_MASK];
+}
+
+static void *sim_thread(void *arg)
+{
+    struct _uart_sim *sim = (struct _uart_sim *) arg;
+    struct pollfd pfd[3];
+    struct timespec ts;
+    long long wake;
+    long long next;
+    long long now;
+    int ret;
+    int i;
+
+    pfd[2].fd = sim->stop_fd[0];
+    pfd[2].events = POLLIN;
+
+    while (1) {
+        now = stats_now_ns();
+        wake = -1;
+
+        for (i = 0; i < 2; i++) {
+            next = sim_give(&sim->dir[i], now);
+
+            if (next != -1 && (wake == -1 || next < wake))
+                wake = next;
+
+            pfd[i].fd = sim->dir[i].in;
+            pfd[i].events =
+                sim->dir[i].head - sim->dir[i].tail < SIM_QUEUE_SIZE ?
+                POLLIN : 0;
+        }
+
+        if (wake != -1) {
+            wake -= now;
+            ts.tv_sec = wake / 1000000000LL;
+            ts.tv_nsec = wake % 1000000000LL;
+        }
+
+        ret = ppoll(pfd, 3, wake == -1 ? NULL : &ts, NULL);
+
+        if (ret == -1) {
+            if (errno == EINTR)
+                continue;
+
+            error("ppoll() failed", 1);
+            break;
+        }
+
+        if (pfd[2].revents)
+            break;
+
+        for (i = 0; i < 2; i++) {
+            if (pfd[i].revents & POLLIN)
+                sim_take(sim, &sim->dir[i]);
+        }
+    }
+
+    return NULL;
+}
+
+static void sim_free(struct _uart_sim *sim)
+{
+    int i;
+
+    for (i = 0; i < 2; i++) {
+        if (sim->slave[i] != -1)
+            close(sim->slave[i]);
+
+        if (sim->master[i] != -1)
+            close(sim->master[i]);
+    }
+
+    free(sim);
+}
+
+struct _uart_sim *sim_open(struct _uart *line, const struct uart_sim_cfg *cfg)
+{
+    struct _uart_sim *sim;
+    int ret;
+    int i;
+
+    sim = (struct _uart_sim *) calloc(1, sizeof(*sim));
+
+    if (!sim) {
+        error("calloc() failed", 1);
+        return NULL;
+    }
+
+    for (i = 0; i < 2; i++) {
+        sim->master[i] = -1;
+        sim->slave[i] = -1;
+    }
+
+    sim->char_ns = 1000000000LL * uart_char_bits(line) / line->baud;
+    sim->data_bits = line->data_bits;
+
+    if (cfg)
+        sim->cfg = (*cfg);
+
+    sim->seed = sim->cfg.seed;
+
+    for (i = 0; i < 2; i++) {
+        if (sim_pty(&sim->master[i], &sim->slave[i], sim->dev[i]) == -1) {
+            sim_free(sim);
+            return NULL;
+        }
+    }
+
+    sim->dir[0].in = sim->master[0];
+    sim->dir[0].out = sim->master[1];
+    sim->dir[1].in = sim->master[1];
+    sim->dir[1].out = sim->master[0];
+
+    if (pipe(sim->stop_fd) == -1) {
+        error("pipe() failed", 1);
+        sim_free(sim);
+        return NULL;
+    }
+
+    ret = pthread_create(&sim->thread, NULL, sim_thread, sim);
+
+    if (ret != 0) {
+        errno = ret;
+        error("pthread_create() failed", 1);
+        close(sim->stop_fd[0]);
+        close(sim->stop_fd[1]);
+        sim_free(sim);
+        return NULL;
+    }
+
+    return sim;
+}
+
+void sim_close(struct _uart_sim *sim)
+{
+    char c = 0;
+
+    if (write(sim->stop_fd[1], &c, 1) == -1)
+        error("write() failed", 1);
+
+    pthread_join(sim->thread, NULL);
+    close(sim->stop_fd[0]);
+    close(sim->stop_fd[1]);
+    sim_free(sim);
+}
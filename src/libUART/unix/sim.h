@@ -0,0 +1,65 @@
+/**
+ *
+ * File Name: unix/sim.h
+ * Title    : UNIX virtual UART simulator
+ * Project  : libUART
+ * Author   : Copyright (C) 2018-2020 Johannes Krottmayer <krjdev@gmail.com>
+ * Created  : 2026-10-19
+ * Modified :
+ * Revised  :
+ * Version  : 0.1.0.0
+ * License  : ISC (see file LICENSE.txt)
+ *
+ * NOTE: This code is currently below version 1.0, and therefore is considered
+ * to be lacking in some functionality or documentation, or may not be fully
+ * tested. Nonetheless, you can expect most functions to work.
+ *
+ */
+
+#ifndef LIBUART_UNIX_SIM_H
+#define LIBUART_UNIX_SIM_H
+
+#include <pthread.h>
+
+#include "../libUART.h"
+#include "uart.h"
+
+/* bytes on the wire per direction, must be a power of two */
+#define SIM_QUEUE_SIZE      4096
+
+/*
+ * One direction of the virtual cable. Bytes read from 'in' (the master
+ * of the sending end) are stamped with the time the receiver would see
+ * them and written to 'out' (the master of the receiving end) once that
+ * time has come.
+ */
+struct sim_dir {
+    int in;
+    int out;
+    unsigned int head;
+    unsigned int tail;
+    long long line_free;
+    long long last_due;
+    unsigned char data[SIM_QUEUE_SIZE];
+    long long due[SIM_QUEUE_SIZE];
+};
+
+struct _uart_sim {
+    int master[2];
+    int slave[2];
+    char dev[2][DEV_NAME_LEN];
+    long long char_ns;
+    int data_bits;
+    struct uart_sim_cfg cfg;
+    unsigned int seed;
+    struct sim_dir dir[2];
+    int stop_fd[2];
+    pthread_t thread;
+};
+
+extern struct _uart_sim *sim_open(struct _uart *line,
+                                  const struct uart_sim_cfg *cfg);
+extern void sim_close(struct _uart_sim *sim);
+extern int sim_pty(int *master, int *slave, char *dev);
+
+#endif
@@ -0,0 +1,89 @@
+/**
+ *
+ * File Name: unix/stats.c
+ * Title    : UNIX UART performance counters
+ * Project  : libUART
+ * Author   : Copyright (C) 2018-2020 Johannes Krottmayer <krjdev@gmail.com>
+ * Created  : 2026-10-19
+ * Modified :
+ * Revised  :
+ * Version  : 0.1.0.0
+ * License  : ISC (see file LICENSE.txt)
+ *
+ * NOTE: This code is currently below version 1.0, and therefore is considered
+ * to be lacking in some functionality or documentation, or may not be fully
+ * tested. Nonetheless, you can expect most functions to work.
+ *
+ */
+
+#include <time.h>
+
+#include "../libUART.h"
+#include "uart.h"
+#include "stats.h"
+
+#define LOAD(uart, counter) \
+    atomic_load_explicit(&(uart)->stats.counter, memory_order_relaxed)
+
+#define CLEAR(uart, counter) \
+    atomic_store_explicit(&(uart)->stats.counter, 0, memory_order_relaxed)
+
+long long stats_now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long) ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+/* not slewed by NTP, for the receive timestamps */
+long long stats_raw_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC_RAW, &ts);
+    return (long long) ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+void stats_reset(struct _uart *uart)
+{
+    CLEAR(uart, rx_bytes);
+    CLEAR(uart, tx_bytes);
+    CLEAR(uart, read_calls);
+    CLEAR(uart, write_calls);
+    CLEAR(uart, short_writes);
+    CLEAR(uart, empty_reads);
+    CLEAR(uart, reconfigs);
+    atomic_store_explicit(&uart->stats.since_ns, stats_now_ns(),
+                          memory_order_relaxed);
+}
+
+void stats_get(struct _uart *uart, struct uart_stats *stats)
+{
+    long long elapsed;
+    double capacity;
+
+    stats->rx_bytes = LOAD(uart, rx_bytes);
+    stats->tx_bytes = LOAD(uart, tx_bytes);
+    stats->read_calls = LOAD(uart, read_calls);
+    stats->write_calls = LOAD(uart, write_calls);
+    stats->short_writes = LOAD(uart, short_writes);
+    stats->empty_reads = LOAD(uart, empty_reads);
+    stats->reconfigs = LOAD(uart, reconfigs);
+
+    elapsed = stats_now_ns() - LOAD(uart, since_ns);
+    stats->elapsed_ms = elapsed / 1000000LL;
+
+    /* characters per second the line can carry in each direction */
+    capacity = (double) uart->baud / uart_char_bits(uart);
+
+    if (elapsed > 0 && capacity > 0) {
+        stats->rx_utilization = stats->rx_bytes /
+                                (capacity * elapsed / 1e9);
+        stats->tx_utilization = stats->tx_bytes /
+                                (capacity * elapsed / 1e9);
+    } else {
+        stats->rx_utilization = 0.0;
+        stats->tx_utilization = 0.0;
+    }
+}
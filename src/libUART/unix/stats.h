@@ -0,0 +1,47 @@
+/**
+ *
+ * File Name: unix/stats.h
+ * Title    : UNIX UART performance counters
+ * Project  : libUART
+ * Author   : Copyright (C) 2018-2020 Johannes Krottmayer <krjdev@gmail.com>
+ * Created  : 2026-10-19
+ * Modified :
+ * Revised  :
+ * Version  : 0.1.0.0
+ * License  : ISC (see file LICENSE.txt)
+ *
+ * NOTE: This code is currently below version 1.0, and therefore is considered
+ * to be lacking in some functionality or documentation, or may not be fully
+ * tested. Nonetheless, you can expect most functions to work.
+ *
+ */
+
+#ifndef LIBUART_UNIX_STATS_H
+#define LIBUART_UNIX_STATS_H
+
+#include <stdatomic.h>
+
+struct _uart;
+struct uart_stats;
+
+struct stats {
+    atomic_ullong rx_bytes;
+    atomic_ullong tx_bytes;
+    atomic_ullong read_calls;
+    atomic_ullong write_calls;
+    atomic_ullong short_writes;
+    atomic_ullong empty_reads;
+    atomic_ullong reconfigs;
+    atomic_llong since_ns;
+};
+
+#define STATS_ADD(uart, counter, n) \
+    atomic_fetch_add_explicit(&(uart)->stats.counter, (n), \
+                              memory_order_relaxed)
+
+extern long long stats_now_ns(void);
+extern long long stats_raw_ns(void);
+extern void stats_reset(struct _uart *uart);
+extern void stats_get(struct _uart *uart, struct uart_stats *stats);
+
+#endif
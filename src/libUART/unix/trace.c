@@ -0,0 +1,167 @@
+/**
+ *
+ * File Name: unix/trace.c
+ * Title    : UNIX UART tracepoints
+ * Project  : libUART
+ * Author   : Copyright (C) 2018-2020 Johannes Krottmayer <krjdev@gmail.com>
+ * Created  : 2026-10-19
+ * Modified :
+ * Revised  :
+ * Version  : 0.1.0.0
+ * License  : ISC (see file LICENSE.txt)
+ *
+ * NOTE: This code is currently below version 1.0, and therefore is considered
+ * to be lacking in some functionality or documentation, or may not be fully
+ * tested. Nonetheless, you can expect most functions to work.
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "error.h"
+#include "trace.h"
+
+#ifdef LIBUART_TRACE
+#include <pthread.h>
+
+__thread struct trace_ring *trace_ring;
+
+/*
+ * Rings outlive their threads, so a dump still sees what they traced,
+ * until a new thread takes the ring over. There are never more rings
+ * than threads tracing at the same time.
+ */
+static struct trace_ring *trace_rings;
+static uint32_t trace_nrings;
+static uint32_t trace_threads;
+static pthread_mutex_t trace_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_once_t trace_once = PTHREAD_ONCE_INIT;
+static pthread_key_t trace_key;
+static int trace_key_ok;
+
+/* called when a thread that traced exits */
+static void trace_ring_exit(void *arg)
+{
+    struct trace_ring *r = (struct trace_ring *) arg;
+
+    pthread_mutex_lock(&trace_lock);
+    r->exited = 1;
+    pthread_mutex_unlock(&trace_lock);
+    trace_ring = NULL;
+}
+
+static void trace_key_create(void)
+{
+    trace_key_ok = pthread_key_create(&trace_key, trace_ring_exit) == 0;
+}
+
+struct trace_ring *trace_ring_new(void)
+{
+    struct trace_ring *r;
+
+    pthread_once(&trace_once, trace_key_create);
+    pthread_mutex_lock(&trace_lock);
+
+    for (r = trace_rings; r; r = r->next) {
+        if (r->exited)
+            break;
+    }
+
+    if (r) {
+        r->exited = 0;
+        atomic_store_explicit(&r->head, 0, memory_order_relaxed);
+    } else {
+        r = (struct trace_ring *) calloc(1, sizeof(*r));
+
+        if (!r) {
+            pthread_mutex_unlock(&trace_lock);
+            return NULL;
+        }
+
+        atomic_init(&r->head, 0);
+        r->next = trace_rings;
+        trace_rings = r;
+        trace_nrings++;
+    }
+
+    r->tid = trace_threads++;
+    pthread_mutex_unlock(&trace_lock);
+
+    /* without the key the ring is kept for good, as if never released */
+    if (trace_key_ok)
+        pthread_setspecific(trace_key, r);
+
+    trace_ring = r;
+    return r;
+}
+
+int trace_dump(const char *path)
+{
+    struct trace_file_hdr hdr;
+    struct trace_thread_hdr thr;
+    struct trace_ring *r;
+    unsigned int head;
+    unsigned int first;
+    unsigned int i;
+    FILE *f;
+    int ret = 0;
+
+    f = fopen(path, "wb");
+
+    if (!f) {
+        error("fopen() failed", 1);
+        return -1;
+    }
+
+    pthread_mutex_lock(&trace_lock);
+    hdr.magic = TRACE_MAGIC;
+    hdr.version = TRACE_VERSION;
+    hdr.threads = trace_nrings;
+    hdr.rec_size = sizeof(struct trace_rec);
+
+    if (fwrite(&hdr, sizeof(hdr), 1, f) != 1)
+        ret = -1;
+
+    /*
+     * Records are copied while their threads keep tracing, the oldest
+     * ones of a ring that wraps during the dump may already be newer.
+     */
+    for (r = trace_rings; r && ret == 0; r = r->next) {
+        head = atomic_load_explicit(&r->head, memory_order_acquire);
+        first = head > TRACE_RING_SIZE ? head - TRACE_RING_SIZE : 0;
+        thr.tid = r->tid;
+        thr.count = head - first;
+
+        if (fwrite(&thr, sizeof(thr), 1, f) != 1) {
+            ret = -1;
+            break;
+        }
+
+        for (i = first; i != head; i++) {
+            if (fwrite(&r->rec[i & (TRACE_RING_SIZE - 1)],
+                       sizeof(struct trace_rec), 1, f) != 1) {
+                ret = -1;
+                break;
+            }
+        }
+    }
+
+    pthread_mutex_unlock(&trace_lock);
+
+    if (fclose(f) != 0)
+        ret = -1;
+
+    if (ret == -1)
+        error_code(UART_ERR_IO, "could not write trace file");
+
+    return ret;
+}
+#else
+int trace_dump(const char *path)
+{
+    (void) path;
+    error_code(UART_ERR_STATE, "tracing not compiled in (build with TRACE=1)");
+    return -1;
+}
+#endif
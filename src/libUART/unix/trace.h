@@ -0,0 +1,133 @@
+/**
+ *
+ * File Name: unix/trace.h
+ * Title    : UNIX UART tracepoints
+ * Project  : libUART
+ * Author   : Copyright (C) 2018-2020 Johannes Krottmayer <krjdev@gmail.com>
+ * Created  : 2026-10-19
+ * Modified :
+ * Revised  :
+ * Version  : 0.1.0.0
+ * License  : ISC (see file LICENSE.txt)
+ *
+ * NOTE: This code is currently below version 1.0, and therefore is considered
+ * to be lacking in some functionality or documentation, or may not be fully
+ * tested. Nonetheless, you can expect most functions to work.
+ *
+ */
+
+#ifndef LIBUART_UNIX_TRACE_H
+#define LIBUART_UNIX_TRACE_H
+
+#include <stdint.h>
+
+/* trace records kept per thread, must be a power of two */
+#define TRACE_RING_SIZE     8192
+
+#define TRACE_MAGIC         0x43525455  /* "UTRC" */
+#define TRACE_VERSION       1
+
+#define TRACE_PHASE_ENTER   0
+#define TRACE_PHASE_EXIT    1
+
+enum e_trace_event {
+    TRACE_SEND,
+    TRACE_SENDV,
+    TRACE_RECV,
+    TRACE_INIT_BAUD,
+    TRACE_INIT_DATABITS,
+    TRACE_INIT_PARITY,
+    TRACE_INIT_STOPBITS,
+    TRACE_INIT_FLOW,
+    TRACE_SET_PIN,
+    TRACE_GET_PIN,
+    TRACE_GET_BYTES,
+    TRACE_EVENTS
+};
+
+/*
+ * Dump file layout: one trace_file_hdr, then for every thread that
+ * traced anything a trace_thread_hdr followed by its records, oldest
+ * first. 'size' is the length, setting or pin the call was made with.
+ */
+struct trace_rec {
+    int64_t ts_ns;
+    uint32_t port;
+    uint16_t event;
+    uint16_t phase;
+    int32_t size;
+    int32_t result;
+};
+
+struct trace_file_hdr {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t threads;
+    uint32_t rec_size;
+};
+
+struct trace_thread_hdr {
+    uint32_t tid;
+    uint32_t count;
+};
+
+extern int trace_dump(const char *path);
+
+#ifdef LIBUART_TRACE
+#include <stdatomic.h>
+#include <time.h>
+
+struct trace_ring {
+    struct trace_ring *next;
+    uint32_t tid;
+    int exited;                 /* free for the next thread that traces */
+    atomic_uint head;
+    struct trace_rec rec[TRACE_RING_SIZE];
+};
+
+extern __thread struct trace_ring *trace_ring
+    __attribute__((visibility("hidden"), tls_model("initial-exec")));
+
+__attribute__((visibility("hidden")))
+extern struct trace_ring *trace_ring_new(void);
+
+/* owner thread only, the dump reads 'head' to find the valid records */
+static inline void trace_event(unsigned int port, int event, int phase,
+                               int size, int result)
+{
+    struct trace_ring *r = trace_ring;
+    struct trace_rec *rec;
+    struct timespec ts;
+    unsigned int head;
+
+    if (!r && !(r = trace_ring_new()))
+        return;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    head = atomic_load_explicit(&r->head, memory_order_relaxed);
+    rec = &r->rec[head & (TRACE_RING_SIZE - 1)];
+    rec->ts_ns = (int64_t) ts.tv_sec * 1000000000LL + ts.tv_nsec;
+    rec->port = port;
+    rec->event = event;
+    rec->phase = phase;
+    rec->size = size;
+    rec->result = result;
+    atomic_store_explicit(&r->head, head + 1, memory_order_release);
+}
+
+#define TRACE_ENTER(uart, event, size) \
+    trace_event((uart)->id, (event), TRACE_PHASE_ENTER, (size), 0)
+
+#define TRACE_RETURN(uart, event, size, value) \
+    do { \
+        int trace_ret_ = (value); \
+        trace_event((uart)->id, (event), TRACE_PHASE_EXIT, (size), \
+                    trace_ret_); \
+        return trace_ret_; \
+    } while (0)
+#else
+#define TRACE_ENTER(uart, event, size)              ((void) 0)
+#define TRACE_RETURN(uart, event, size, value)      return (value)
+#endif
+
+#endif
@@ -0,0 +1,354 @@
+/**
+ *
+ * File Name: unix/txq.c
+ * Title    : UNIX UART transmit queue
+ * Project  : libUART
+ * Author   : Copyright (C) 2018-2020 Johannes Krottmayer <krjdev@gmail.com>
+ * Created  : 2026-10-19
+ * Modified :
+ * Revised  :
+ * Version  : 0.1.0.0
+ * License  : ISC (see file LICENSE.txt)
+ *
+ * NOTE: This code is currently below version 1.0, and therefore is considered
+ * to be lacking in some functionality or documentation, or may not be fully
+ * tested. Nonetheless, you can expect most functions to work.
+ *
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <sys/uio.h>
+
+#include "error.h"
+#include "uart.h"
+#include "txq.h"
+
+static void txq_push(struct txq *q, struct txq_msg *m)
+{
+    struct txq_msg *prev;
+
+    atomic_store_explicit(&m->next, NULL, memory_order_relaxed);
+    prev = atomic_exchange_explicit(&q->tail, m, memory_order_acq_rel);
+    atomic_store_explicit(&prev->next, m, memory_order_release);
+}
+
+/* consumer only, returns NULL if empty or a producer is halfway through */
+static struct txq_msg *txq_pop(struct txq *q)
+{
+    struct txq_msg *head = q->head;
+    struct txq_msg *next;
+
+    next = atomic_load_explicit(&head->next, memory_order_acquire);
+
+    if (head == &q->stub) {
+        if (!next)
+            return NULL;
+
+        q->head = next;
+        head = next;
+        next = atomic_load_explicit(&head->next, memory_order_acquire);
+    }
+
+    if (next) {
+        q->head = next;
+        return head;
+    }
+
+    if (head != atomic_load_explicit(&q->tail, memory_order_acquire))
+        return NULL;
+
+    txq_push(q, &q->stub);
+    next = atomic_load_explicit(&head->next, memory_order_acquire);
+
+    if (next) {
+        q->head = next;
+        return head;
+    }
+
+    return NULL;
+}
+
+static void txq_buf_put(struct txq_buf *b)
+{
+    if (atomic_fetch_sub(&b->refs, 1) != 1)
+        return;
+
+    if (b->release)
+        b->release(b->arg);
+
+    free(b);
+}
+
+static void txq_free(struct txq_msg *m)
+{
+    if (m->buf)
+        txq_buf_put(m->buf);
+
+    free(m);
+}
+
+int txq_create(struct _uart *uart)
+{
+    struct txq *q;
+    int ret;
+
+    ret = posix_memalign((void **) &q, CACHE_LINE_SIZE, sizeof(*q));
+
+    if (ret != 0) {
+        errno = ret;
+        error("posix_memalign() failed", 1);
+        return -1;
+    }
+
+    memset(q, 0, sizeof(*q));
+    atomic_init(&q->stub.next, NULL);
+    atomic_init(&q->tail, &q->stub);
+    atomic_init(&q->queued, 0);
+    atomic_init(&q->pending, 0);
+    atomic_init(&q->draining, 0);
+    atomic_init(&q->failed, 0);
+    q->head = &q->stub;
+    uart->txq = q;
+    return 0;
+}
+
+void txq_destroy(struct _uart *uart)
+{
+    struct txq *q = uart->txq;
+    struct txq_msg *m;
+    struct txq_msg *next;
+
+    if (!q)
+        return;
+
+    for (m = q->out_head; m; m = next) {
+        next = atomic_load_explicit(&m->next, memory_order_relaxed);
+        txq_free(m);
+    }
+
+    while ((m = txq_pop(q)))
+        txq_free(m);
+
+    free(q);
+    uart->txq = NULL;
+}
+
+/*
+ * Once pushed, a message is sent sooner or later and can't be taken back,
+ * so a failed write does not fail the call that queued it. The error is
+ * reported by the next call instead, which queues nothing while the port
+ * still refuses data: -1 always means the message was not queued.
+ */
+static int txq_queue(struct _uart *uart, struct txq_msg *m)
+{
+    struct txq *q = uart->txq;
+
+    if (atomic_load(&q->failed) && txq_drain(uart) == -1) {
+        txq_free(m);
+        return -1;
+    }
+
+    atomic_fetch_add(&q->pending, m->len);
+    txq_push(q, m);
+    atomic_fetch_add(&q->queued, 1);
+    txq_drain(uart);
+    return m->len;
+}
+
+int txq_send(struct _uart *uart, const char *send_buf, int len)
+{
+    struct txq_msg *m;
+    char *data;
+
+    if (len == 0)
+        return 0;
+
+    m = (struct txq_msg *) malloc(sizeof(*m) + len);
+
+    if (!m) {
+        error("malloc() failed", 1);
+        return -1;
+    }
+
+    data = (char *) (m + 1);
+    memcpy(data, send_buf, len);
+    m->data = data;
+    m->len = len;
+    m->off = 0;
+    m->buf = NULL;
+    return txq_queue(uart, m);
+}
+
+/*
+ * Queue one payload to many ports. Every port gets its own small message
+ * pointing into the shared buffer, the buffer is released when the last
+ * port has written it. Without a release callback the payload is copied
+ * once into the buffer.
+ */
+int txq_broadcast(struct _uart **uart, int num, const char *send_buf, int len,
+                  uart_release_cb release, void *arg, int *status)
+{
+    struct txq_buf *b;
+    struct txq_msg *m;
+    char *data;
+    int queued = 0;
+    int ret;
+    int i;
+
+    /* nothing to queue, the buffer is not needed any more */
+    if (len == 0) {
+        for (i = 0; status && i < num; i++)
+            status[i] = 0;
+
+        if (release)
+            release(arg);
+
+        return 0;
+    }
+
+    b = (struct txq_buf *) malloc(sizeof(*b) + (release ? 0 : len));
+
+    if (!b) {
+        error("malloc() failed", 1);
+        return -1;
+    }
+
+    if (release) {
+        b->data = send_buf;
+    } else {
+        data = (char *) (b + 1);
+        memcpy(data, send_buf, len);
+        b->data = data;
+    }
+
+    b->release = release;
+    b->arg = arg;
+    /* our reference keeps the buffer while it is being queued */
+    atomic_init(&b->refs, 1);
+
+    for (i = 0; i < num; i++) {
+        m = (struct txq_msg *) malloc(sizeof(*m));
+
+        if (!m) {
+            error("malloc() failed", 1);
+
+            if (status)
+                status[i] = -1;
+
+            continue;
+        }
+
+        atomic_fetch_add(&b->refs, 1);
+        m->data = b->data;
+        m->len = len;
+        m->off = 0;
+        m->buf = b;
+        ret = txq_queue(uart[i], m);
+
+        if (ret != -1)
+            queued++;
+
+        if (status)
+            status[i] = ret;
+    }
+
+    txq_buf_put(b);
+    return queued;
+}
+
+/* must only be called by the owner of the 'draining' flag */
+static int txq_write(struct _uart *uart)
+{
+    struct txq *q = uart->txq;
+    struct iovec iov[TXQ_BATCH];
+    struct txq_msg *m;
+    int cnt;
+    int ret;
+    int n;
+
+    while ((m = txq_pop(q))) {
+        atomic_fetch_sub(&q->queued, 1);
+        atomic_store_explicit(&m->next, NULL, memory_order_relaxed);
+
+        if (q->out_tail)
+            atomic_store_explicit(&q->out_tail->next, m,
+                                  memory_order_relaxed);
+        else
+            q->out_head = m;
+
+        q->out_tail = m;
+    }
+
+    while (q->out_head) {
+        cnt = 0;
+
+        for (m = q->out_head; m && cnt < TXQ_BATCH;
+             m = atomic_load_explicit(&m->next, memory_order_relaxed)) {
+            iov[cnt].iov_base = (void *) (m->data + m->off);
+            iov[cnt].iov_len = m->len - m->off;
+            cnt++;
+        }
+
+        ret = uart_sendv(uart, iov, cnt);
+
+        if (ret == -1)
+            return -1;
+
+        /* kernel buffer full, the rest stays queued */
+        if (ret == 0)
+            break;
+
+        atomic_fetch_sub(&q->pending, ret);
+
+        while (ret > 0) {
+            m = q->out_head;
+            n = m->len - m->off;
+
+            if (ret < n) {
+                m->off += ret;
+                break;
+            }
+
+            ret -= n;
+            q->out_head = atomic_load_explicit(&m->next,
+                                               memory_order_relaxed);
+            txq_free(m);
+        }
+
+        if (!q->out_head)
+            q->out_tail = NULL;
+    }
+
+    return 0;
+}
+
+int txq_drain(struct _uart *uart)
+{
+    struct txq *q = uart->txq;
+    int ret;
+
+    while (1) {
+        /* somebody else is writing, it will pick up our messages */
+        if (atomic_exchange(&q->draining, 1))
+            return 0;
+
+        ret = txq_write(uart);
+        atomic_store(&q->draining, 0);
+
+        /*
+         * A producer may have queued a message after our last pop and
+         * failed to take the flag while we still held it.
+         */
+        if (ret == -1 || atomic_load(&q->queued) == 0) {
+            atomic_store(&q->failed, ret == -1);
+            return ret;
+        }
+    }
+}
+
+int txq_pending(struct _uart *uart)
+{
+    return atomic_load(&uart->txq->pending);
+}
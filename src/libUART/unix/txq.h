@@ -0,0 +1,75 @@
+/**
+ *
+ * File Name: unix/txq.h
+ * Title    : UNIX UART transmit queue
+ * Project  : libUART
+ * Author   : Copyright (C) 2018-2020 Johannes Krottmayer <krjdev@gmail.com>
+ * Created  : 2026-10-19
+ * Modified :
+ * Revised  :
+ * Version  : 0.1.0.0
+ * License  : ISC (see file LICENSE.txt)
+ *
+ * NOTE: This code is currently below version 1.0, and therefore is considered
+ * to be lacking in some functionality or documentation, or may not be fully
+ * tested. Nonetheless, you can expect most functions to work.
+ *
+ */
+
+#ifndef LIBUART_UNIX_TXQ_H
+#define LIBUART_UNIX_TXQ_H
+
+#include <stdatomic.h>
+
+#include "../libUART.h"
+#include "../util.h"
+
+/* maximum number of messages written with a single writev() */
+#define TXQ_BATCH           64
+
+struct _uart;
+
+/* payload shared by the messages of a broadcast */
+struct txq_buf {
+    atomic_int refs;
+    const char *data;
+    uart_release_cb release;    /* NULL if the payload follows the header */
+    void *arg;
+};
+
+struct txq_msg {
+    struct txq_msg *_Atomic next;
+    const char *data;
+    int len;
+    int off;
+    struct txq_buf *buf;        /* NULL if the data follows the header */
+};
+
+/*
+ * Multi-producer/single-consumer message queue (intrusive Vyukov queue).
+ * Producers only touch 'tail'. Whoever wins the 'draining' flag becomes
+ * the single consumer and owns 'head', 'stub' and the list of messages
+ * already taken off the queue but not completely written yet.
+ */
+struct txq {
+    _Alignas(CACHE_LINE_SIZE) struct txq_msg *_Atomic tail;
+    atomic_int queued;
+    atomic_int pending;
+    atomic_int failed;          /* the last drain hit a write error */
+    _Alignas(CACHE_LINE_SIZE) atomic_int draining;
+    struct txq_msg *head;
+    struct txq_msg stub;
+    struct txq_msg *out_head;
+    struct txq_msg *out_tail;
+};
+
+extern int txq_create(struct _uart *uart);
+extern void txq_destroy(struct _uart *uart);
+extern int txq_send(struct _uart *uart, const char *send_buf, int len);
+extern int txq_drain(struct _uart *uart);
+extern int txq_pending(struct _uart *uart);
+extern int txq_broadcast(struct _uart **uart, int num, const char *send_buf,
+                         int len, uart_release_cb release, void *arg,
+                         int *status);
+
+#endif
@@ -19,15 +19,37 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <errno.h>
 #include <fcntl.h>
 #include <unistd.h>
 #include <termios.h>
+#include <pthread.h>
+#include <poll.h>
 #include <sys/ioctl.h>
 
 #include "../libUART.h"
 #include "../util.h"
 #include "error.h"
 #include "uart.h"
+#include "reader.h"
+#include "txq.h"
+#include "stats.h"
+#include "latency.h"
+#include "trace.h"
+#include "capture.h"
+#include "replay.h"
+#include "manager.h"
+#include "hotplug.h"
+#include "reconnect.h"
+#include "bridge.h"
+#include "share.h"
+#include "backend.h"
+
+/* port ids for traces and logs, 0 is never used */
+static atomic_uint uart_next_id;
+
+/* the hotplug monitor and the reconnect thread may race */
+static pthread_mutex_t uart_reopen_mutex = PTHREAD_MUTEX_INITIALIZER;
 
 int uart_baud_valid(int value)
 {
@@ -71,11 +93,51 @@ int uart_baud_valid(int value)
     return 0;
 }
 
-int uart_init_baud(struct _uart *uart)
+/* bits on the line per character: start, data, parity and stop bits */
+int uart_char_bits(struct _uart *uart)
+{
+    return 1 + uart->data_bits + (uart->parity != UART_PARITY_NO) +
+           uart->stop_bits;
+}
+
+/* time of one character on the line, 0 while the baud rate is 0 */
+long long uart_char_ns(struct _uart *uart)
+{
+    if (uart->baud <= 0)
+        return 0;
+    
+    return 1000000000LL * uart_char_bits(uart) / uart->baud;
+}
+
+/*
+ * The last of 'len' bytes read at 'rx_ns' arrived just before, the
+ * others back to back one character time apart.
+ */
+void uart_rx_ts_set(struct _uart *uart, struct uart_rx_ts *ts,
+                    long long rx_ns, int len)
+{
+    ts->rx_ns = rx_ns;
+    ts->first_ns = rx_ns - (len - 1) * uart_char_ns(uart);
+}
+
+/* read-modify-write of the line settings for a single setting change */
+static int uart_reconf(struct _uart *uart,
+                       int (*conf)(struct _uart *, struct termios *))
 {
     int ret;
     struct termios options;
     
+    /* other backends check the setting on a scratch copy */
+    if (uart->be->configure) {
+        memset(&options, 0, sizeof(options));
+        
+        if (conf(uart, &options) == -1 || uart->be->configure(uart) == -1)
+            return -1;
+        
+        STATS_ADD(uart, reconfigs, 1);
+        return 0;
+    }
+    
     ret = tcgetattr(uart->fd, &options);
     
     if (ret == -1) {
@@ -83,16 +145,36 @@ int uart_init_baud(struct _uart *uart)
         return -1;
     }
     
+    ret = conf(uart, &options);
+    
+    if (ret == -1)
+        return -1;
+    
+    ret = tcsetattr(uart->fd, TCSANOW, &options);
+    
+    if (ret == -1) {
+        error("tcsetattr() failed", 1);
+        return -1;
+    }
+    
+    STATS_ADD(uart, reconfigs, 1);
+    return 0;
+}
+
+static int uart_conf_baud(struct _uart *uart, struct termios *options)
+{
+    int ret;
+    
     switch (uart->baud) {
     case UART_BAUD_0:
-        ret = cfsetispeed(&options, B0);
+        ret = cfsetispeed(options, B0);
         
         if (ret == -1) {
             error("cfsetispeed() failed", 1);
             return -1;
         }
         
-        ret = cfsetospeed(&options, B0);
+        ret = cfsetospeed(options, B0);
         
         if (ret == -1) {
             error("cfsetospeed() failed", 1);
@@ -101,14 +183,14 @@ int uart_init_baud(struct _uart *uart)
 
         break;
     case UART_BAUD_50:
-        ret = cfsetispeed(&options, B50);
+        ret = cfsetispeed(options, B50);
         
         if (ret == -1) {
             error("cfsetispeed() failed", 1);
             return -1;
         }
         
-        ret = cfsetospeed(&options, B50);
+        ret = cfsetospeed(options, B50);
         
         if (ret == -1) {
             error("cfsetospeed() failed", 1);
@@ -117,14 +199,14 @@ int uart_init_baud(struct _uart *uart)
 
         break;
     case UART_BAUD_75:
-        ret = cfsetispeed(&options, B75);
+        ret = cfsetispeed(options, B75);
         
         if (ret == -1) {
             error("cfsetispeed() failed", 1);
             return -1;
         }
         
-        ret = cfsetospeed(&options, B75);
+        ret = cfsetospeed(options, B75);
         
         if (ret == -1) {
             error("cfsetospeed() failed", 1);
@@ -133,14 +215,14 @@ int uart_init_baud(struct _uart *uart)
 
         break;
     case UART_BAUD_110:
-        ret = cfsetispeed(&options, B110);
+        ret = cfsetispeed(options, B110);
         
         if (ret == -1) {
             error("cfsetispeed() failed", 1);
             return -1;
         }
         
-        ret = cfsetospeed(&options, B110);
+        ret = cfsetospeed(options, B110);
         
         if (ret == -1) {
             error("cfsetospeed() failed", 1);
@@ -149,14 +231,14 @@ int uart_init_baud(struct _uart *uart)
         
         break;
     case UART_BAUD_134:
-        ret = cfsetispeed(&options, B134);
+        ret = cfsetispeed(options, B134);
         
         if (ret == -1) {
             error("cfsetispeed() failed", 1);
             return -1;
         }
         
-        ret = cfsetospeed(&options, B134);
+        ret = cfsetospeed(options, B134);
         
         if (ret == -1) {
             error("cfsetospeed() failed", 1);
@@ -165,14 +247,14 @@ int uart_init_baud(struct _uart *uart)
 
         break;
     case UART_BAUD_150:
-        ret = cfsetispeed(&options, B150);
+        ret = cfsetispeed(options, B150);
         
         if (ret == -1) {
             error("cfsetispeed() failed", 1);
             return -1;
         }
         
-        ret = cfsetospeed(&options, B150);
+        ret = cfsetospeed(options, B150);
         
         if (ret == -1) {
             error("cfsetospeed() failed", 1);
@@ -181,14 +263,14 @@ int uart_init_baud(struct _uart *uart)
 
         break;
     case UART_BAUD_200:
-        ret = cfsetispeed(&options, B200);
+        ret = cfsetispeed(options, B200);
         
         if (ret == -1) {
             error("cfsetispeed() failed", 1);
             return -1;
         }
         
-        ret = cfsetospeed(&options, B200);
+        ret = cfsetospeed(options, B200);
         
         if (ret == -1) {
             error("cfsetospeed() failed", 1);
@@ -197,14 +279,14 @@ int uart_init_baud(struct _uart *uart)
 
         break;
     case UART_BAUD_300:
-        ret = cfsetispeed(&options, B300);
+        ret = cfsetispeed(options, B300);
         
         if (ret == -1) {
             error("cfsetispeed() failed", 1);
             return -1;
         }
         
-        ret = cfsetospeed(&options, B300);
+        ret = cfsetospeed(options, B300);
         
         if (ret == -1) {
             error("cfsetospeed() failed", 1);
@@ -213,14 +295,14 @@ int uart_init_baud(struct _uart *uart)
         
         break;
     case UART_BAUD_600:
-        ret = cfsetispeed(&options, B600);
+        ret = cfsetispeed(options, B600);
         
         if (ret == -1) {
             error("cfsetispeed() failed", 1);
             return -1;
         }
         
-        ret = cfsetospeed(&options, B600);
+        ret = cfsetospeed(options, B600);
         
         if (ret == -1) {
             error("cfsetospeed() failed", 1);
@@ -229,14 +311,14 @@ int uart_init_baud(struct _uart *uart)
         
         break;
     case UART_BAUD_1200:
-        ret = cfsetispeed(&options, B1200);
+        ret = cfsetispeed(options, B1200);
         
         if (ret == -1) {
             error("cfsetispeed() failed", 1);
             return -1;
         }
         
-        ret = cfsetospeed(&options, B1200);
+        ret = cfsetospeed(options, B1200);
         
         if (ret == -1) {
             error("cfsetospeed() failed", 1);
@@ -245,14 +327,14 @@ int uart_init_baud(struct _uart *uart)
         
         break;
     case UART_BAUD_1800:
-        ret = cfsetispeed(&options, B1800);
+        ret = cfsetispeed(options, B1800);
         
         if (ret == -1) {
             error("cfsetispeed() failed", 1);
             return -1;
         }
         
-        ret = cfsetospeed(&options, B1800);
+        ret = cfsetospeed(options, B1800);
         
         if (ret == -1) {
             error("cfsetospeed() failed", 1);
@@ -261,14 +343,14 @@ int uart_init_baud(struct _uart *uart)
 
         break;
     case UART_BAUD_2400:
-        ret = cfsetispeed(&options, B2400);
+        ret = cfsetispeed(options, B2400);
         
         if (ret == -1) {
             error("cfsetispeed() failed", 1);
             return -1;
         }
         
-        ret = cfsetospeed(&options, B2400);
+        ret = cfsetospeed(options, B2400);
         
         if (ret == -1) {
             error("cfsetospeed() failed", 1);
@@ -277,14 +359,14 @@ int uart_init_baud(struct _uart *uart)
         
         break;
     case UART_BAUD_4800:
-        ret = cfsetispeed(&options, B4800);
+        ret = cfsetispeed(options, B4800);
         
         if (ret == -1) {
             error("cfsetispeed() failed", 1);
             return -1;
         }
         
-        ret = cfsetospeed(&options, B4800);
+        ret = cfsetospeed(options, B4800);
         
         if (ret == -1) {
             error("cfsetospeed() failed", 1);
@@ -293,14 +375,14 @@ int uart_init_baud(struct _uart *uart)
         
         break;
     case UART_BAUD_9600:
-        ret = cfsetispeed(&options, B9600);
+        ret = cfsetispeed(options, B9600);
         
         if (ret == -1) {
             error("cfsetispeed() failed", 1);
             return -1;
         }
         
-        ret = cfsetospeed(&options, B9600);
+        ret = cfsetospeed(options, B9600);
         
         if (ret == -1) {
             error("cfsetospeed() failed", 1);
@@ -309,14 +391,14 @@ int uart_init_baud(struct _uart *uart)
         
         break;
     case UART_BAUD_19200:
-        ret = cfsetispeed(&options, B19200);
+        ret = cfsetispeed(options, B19200);
         
         if (ret == -1) {
             error("cfsetispeed() failed", 1);
             return -1;
         }
         
-        ret = cfsetospeed(&options, B19200);
+        ret = cfsetospeed(options, B19200);
         
         if (ret == -1) {
             error("cfsetospeed() failed", 1);
@@ -325,14 +407,14 @@ int uart_init_baud(struct _uart *uart)
         
         break;
     case UART_BAUD_38400:
-        ret = cfsetispeed(&options, B38400);
+        ret = cfsetispeed(options, B38400);
         
         if (ret == -1) {
             error("cfsetispeed() failed", 1);
             return -1;
         }
         
-        ret = cfsetospeed(&options, B38400);
+        ret = cfsetospeed(options, B38400);
         
         if (ret == -1) {
             error("cfsetospeed() failed", 1);
@@ -341,14 +423,14 @@ int uart_init_baud(struct _uart *uart)
         
         break;
     case UART_BAUD_57600:
-        ret = cfsetispeed(&options, B57600);
+        ret = cfsetispeed(options, B57600);
         
         if (ret == -1) {
             error("cfsetispeed() failed", 1);
             return -1;
         }
         
-        ret = cfsetospeed(&options, B57600);
+        ret = cfsetospeed(options, B57600);
         
         if (ret == -1) {
             error("cfsetospeed() failed", 1);
@@ -357,14 +439,14 @@ int uart_init_baud(struct _uart *uart)
         
         break;
     case UART_BAUD_115200:
-        ret = cfsetispeed(&options, B115200);
+        ret = cfsetispeed(options, B115200);
         
         if (ret == -1) {
             error("cfsetispeed() failed", 1);
             return -1;
         }
         
-        ret = cfsetospeed(&options, B115200);
+        ret = cfsetospeed(options, B115200);
         
         if (ret == -1) {
             error("cfsetospeed() failed", 1);
@@ -373,14 +455,14 @@ int uart_init_baud(struct _uart *uart)
         
         break;
     case UART_BAUD_230400:
-        ret = cfsetispeed(&options, B230400);
+        ret = cfsetispeed(options, B230400);
         
         if (ret == -1) {
             error("cfsetispeed() failed", 1);
             return -1;
         }
         
-        ret = cfsetospeed(&options, B230400);
+        ret = cfsetospeed(options, B230400);
         
         if (ret == -1) {
             error("cfsetospeed() failed", 1);
@@ -389,14 +471,14 @@ int uart_init_baud(struct _uart *uart)
 
         break;
     case UART_BAUD_460800:
-        ret = cfsetispeed(&options, B460800);
+        ret = cfsetispeed(options, B460800);
         
         if (ret == -1) {
             error("cfsetispeed() failed", 1);
             return -1;
         }
         
-        ret = cfsetospeed(&options, B460800);
+        ret = cfsetospeed(options, B460800);
         
         if (ret == -1) {
             error("cfsetospeed() failed", 1);
@@ -405,14 +487,14 @@ int uart_init_baud(struct _uart *uart)
 
         break;
     case UART_BAUD_500000:
-        ret = cfsetispeed(&options, B500000);
+        ret = cfsetispeed(options, B500000);
         
         if (ret == -1) {
             error("cfsetispeed() failed", 1);
             return -1;
         }
         
-        ret = cfsetospeed(&options, B500000);
+        ret = cfsetospeed(options, B500000);
         
         if (ret == -1) {
             error("cfsetospeed() failed", 1);
@@ -421,14 +503,14 @@ int uart_init_baud(struct _uart *uart)
 
         break;
     case UART_BAUD_576000:
-        ret = cfsetispeed(&options, B576000);
+        ret = cfsetispeed(options, B576000);
         
         if (ret == -1) {
             error("cfsetispeed() failed", 1);
             return -1;
         }
         
-        ret = cfsetospeed(&options, B576000);
+        ret = cfsetospeed(options, B576000);
         
         if (ret == -1) {
             error("cfsetospeed() failed", 1);
@@ -437,14 +519,14 @@ int uart_init_baud(struct _uart *uart)
 
         break;
     case UART_BAUD_921600:
-        ret = cfsetispeed(&options, B921600);
+        ret = cfsetispeed(options, B921600);
         
         if (ret == -1) {
             error("cfsetispeed() failed", 1);
             return -1;
         }
         
-        ret = cfsetospeed(&options, B921600);
+        ret = cfsetospeed(options, B921600);
         
         if (ret == -1) {
             error("cfsetospeed() failed", 1);
@@ -453,14 +535,14 @@ int uart_init_baud(struct _uart *uart)
 
         break;
     case UART_BAUD_1000000:
-        ret = cfsetispeed(&options, B1000000);
+        ret = cfsetispeed(options, B1000000);
         
         if (ret == -1) {
             error("cfsetispeed() failed", 1);
             return -1;
         }
         
-        ret = cfsetospeed(&options, B1000000);
+        ret = cfsetospeed(options, B1000000);
         
         if (ret == -1) {
             error("cfsetospeed() failed", 1);
@@ -469,14 +551,14 @@ int uart_init_baud(struct _uart *uart)
 
         break;
     case UART_BAUD_1152000:
-        ret = cfsetispeed(&options, B1152000);
+        ret = cfsetispeed(options, B1152000);
         
         if (ret == -1) {
             error("cfsetispeed() failed", 1);
             return -1;
         }
         
-        ret = cfsetospeed(&options, B1152000);
+        ret = cfsetospeed(options, B1152000);
         
         if (ret == -1) {
             error("cfsetospeed() failed", 1);
@@ -485,14 +567,14 @@ int uart_init_baud(struct _uart *uart)
 
         break;
     case UART_BAUD_1500000:
-        ret = cfsetispeed(&options, B1500000);
+        ret = cfsetispeed(options, B1500000);
         
         if (ret == -1) {
             error("cfsetispeed() failed", 1);
             return -1;
         }
         
-        ret = cfsetospeed(&options, B1500000);
+        ret = cfsetospeed(options, B1500000);
         
         if (ret == -1) {
             error("cfsetospeed() failed", 1);
@@ -501,14 +583,14 @@ int uart_init_baud(struct _uart *uart)
 
         break;
     case UART_BAUD_2000000:
-        ret = cfsetispeed(&options, B2000000);
+        ret = cfsetispeed(options, B2000000);
         
         if (ret == -1) {
             error("cfsetispeed() failed", 1);
             return -1;
         }
         
-        ret = cfsetospeed(&options, B2000000);
+        ret = cfsetospeed(options, B2000000);
         
         if (ret == -1) {
             error("cfsetospeed() failed", 1);
@@ -517,14 +599,14 @@ int uart_init_baud(struct _uart *uart)
 
         break;
     case UART_BAUD_2500000:
-        ret = cfsetispeed(&options, B2500000);
+        ret = cfsetispeed(options, B2500000);
         
         if (ret == -1) {
             error("cfsetispeed() failed", 1);
             return -1;
         }
         
-        ret = cfsetospeed(&options, B2500000);
+        ret = cfsetospeed(options, B2500000);
         
         if (ret == -1) {
             error("cfsetospeed() failed", 1);
@@ -533,14 +615,14 @@ int uart_init_baud(struct _uart *uart)
 
         break;
     case UART_BAUD_3000000:
-        ret = cfsetispeed(&options, B3000000);
+        ret = cfsetispeed(options, B3000000);
         
         if (ret == -1) {
             error("cfsetispeed() failed", 1);
             return -1;
         }
         
-        ret = cfsetospeed(&options, B3000000);
+        ret = cfsetospeed(options, B3000000);
         
         if (ret == -1) {
             error("cfsetospeed() failed", 1);
@@ -549,14 +631,14 @@ int uart_init_baud(struct _uart *uart)
 
         break;
     case UART_BAUD_3500000:
-        ret = cfsetispeed(&options, B3500000);
+        ret = cfsetispeed(options, B3500000);
         
         if (ret == -1) {
             error("cfsetispeed() failed", 1);
             return -1;
         }
         
-        ret = cfsetospeed(&options, B3500000);
+        ret = cfsetospeed(options, B3500000);
         
         if (ret == -1) {
             error("cfsetospeed() failed", 1);
@@ -565,14 +647,14 @@ int uart_init_baud(struct _uart *uart)
 
         break;
     case UART_BAUD_4000000:
-        ret = cfsetispeed(&options, B4000000);
+        ret = cfsetispeed(options, B4000000);
         
         if (ret == -1) {
             error("cfsetispeed() failed", 1);
             return -1;
         }
         
-        ret = cfsetospeed(&options, B4000000);
+        ret = cfsetospeed(options, B4000000);
         
         if (ret == -1) {
             error("cfsetospeed() failed", 1);
@@ -585,171 +667,153 @@ int uart_init_baud(struct _uart *uart)
         return -1;
     }
     
-    ret = tcsetattr(uart->fd, TCSANOW, &options);
-    
-    if (ret == -1) {
-            error("tcsetattr() failed", 1);
-            return -1;
-    }
-    
     return 0;
 }
 
-int uart_init_databits(struct _uart *uart)
+int uart_init_baud(struct _uart *uart)
 {
     int ret;
-    struct termios options;
-    
-    ret = tcgetattr(uart->fd, &options);
-    
-    if (ret == -1) {
-        error("tcgetattr() failed", 1);
-        return -1;
-    }
     
+    TRACE_ENTER(uart, TRACE_INIT_BAUD, uart->baud);
+    ret = uart_reconf(uart, uart_conf_baud);
+    TRACE_RETURN(uart, TRACE_INIT_BAUD, uart->baud, ret);
+}
+
+static int uart_conf_databits(struct _uart *uart, struct termios *options)
+{
     switch (uart->data_bits) {
     case 5:
-        options.c_cflag &= ~CSIZE;
-        options.c_cflag |= CS5;
+        options->c_cflag &= ~CSIZE;
+        options->c_cflag |= CS5;
         break;
     case 6:
-        options.c_cflag &= ~CSIZE;
-        options.c_cflag |= CS6;
+        options->c_cflag &= ~CSIZE;
+        options->c_cflag |= CS6;
         break;
     case 7:
-        options.c_cflag &= ~CSIZE;
-        options.c_cflag |= CS7;
+        options->c_cflag &= ~CSIZE;
+        options->c_cflag |= CS7;
         break;
     case 8:
-        options.c_cflag &= ~CSIZE;
-        options.c_cflag |= CS8;
+        options->c_cflag &= ~CSIZE;
+        options->c_cflag |= CS8;
         break;
     default:
         error("invalid Data Bits", 0);
         return -1;
     }
     
-    ret = tcsetattr(uart->fd, TCSANOW, &options);
-    
-    if (ret == -1) {
-        error("tcsetattr() failed", 1);
-        return -1;
-    }
-    
     return 0;
 }
 
-int uart_init_parity(struct _uart *uart)
+int uart_init_databits(struct _uart *uart)
 {
     int ret;
-    struct termios options;
-    
-    ret = tcgetattr(uart->fd, &options);
-    
-    if (ret == -1) {
-        error("tcgetattr() failed", 1);
-        return -1;
-    }
     
+    TRACE_ENTER(uart, TRACE_INIT_DATABITS, uart->data_bits);
+    ret = uart_reconf(uart, uart_conf_databits);
+    TRACE_RETURN(uart, TRACE_INIT_DATABITS, uart->data_bits, ret);
+}
+
+static int uart_conf_parity(struct _uart *uart, struct termios *options)
+{
     switch (uart->parity) {
     case UART_PARITY_NO:
-        options.c_cflag &= ~PARENB;
+        options->c_cflag &= ~PARENB;
         break;
     case UART_PARITY_ODD:
-        options.c_cflag |= PARENB;
-        options.c_cflag |= PARODD;
+        options->c_cflag |= PARENB;
+        options->c_cflag |= PARODD;
         break;
     case UART_PARITY_EVEN:
-        options.c_cflag |= PARENB;
-        options.c_cflag &= ~PARODD;
+        options->c_cflag |= PARENB;
+        options->c_cflag &= ~PARODD;
         break;
     default:
         error("invalid Parity", 0);
         return -1;
     }
     
-    ret = tcsetattr(uart->fd, TCSANOW, &options);
-    
-    if (ret == -1) {
-        error("tcsetattr() failed", 1);
-        return -1;
-    }
-    
     return 0;
 }
 
-int uart_init_stopbits(struct _uart *uart)
+int uart_init_parity(struct _uart *uart)
 {
     int ret;
-    struct termios options;
-    
-    ret = tcgetattr(uart->fd, &options);
-    
-    if (ret == -1) {
-        error("tcgetattr() failed", 1);
-        return -1;
-    }
     
+    TRACE_ENTER(uart, TRACE_INIT_PARITY, uart->parity);
+    ret = uart_reconf(uart, uart_conf_parity);
+    TRACE_RETURN(uart, TRACE_INIT_PARITY, uart->parity, ret);
+}
+
+static int uart_conf_stopbits(struct _uart *uart, struct termios *options)
+{
     switch (uart->stop_bits) {
     case 1:
-        options.c_cflag &= ~CSTOPB;
+        options->c_cflag &= ~CSTOPB;
         break;
     case 2:
-        options.c_cflag |= CSTOPB;
+        options->c_cflag |= CSTOPB;
         break;
     default:
         error("invalid Stop Bits", 0);
         return -1;
     }
     
-    ret = tcsetattr(uart->fd, TCSANOW, &options);
-    
-    if (ret == -1) {
-        error("tcsetattr() failed", 1);
-        return -1;
-    }
-    
     return 0;
 }
 
-int uart_init_flow(struct _uart *uart)
+int uart_init_stopbits(struct _uart *uart)
 {
     int ret;
-    struct termios options;
-    
-    ret = tcgetattr(uart->fd, &options);
-    
-    if (ret == -1) {
-        error("tcgetattr() failed", 1);
-        return -1;
-    }
     
+    TRACE_ENTER(uart, TRACE_INIT_STOPBITS, uart->stop_bits);
+    ret = uart_reconf(uart, uart_conf_stopbits);
+    TRACE_RETURN(uart, TRACE_INIT_STOPBITS, uart->stop_bits, ret);
+}
+
+static int uart_conf_flow(struct _uart *uart, struct termios *options)
+{
     switch (uart->flow_ctrl) {
     case UART_FLOW_NO:
-        options.c_cflag &= ~CRTSCTS;
-        options.c_iflag &= ~(IXON | IXOFF | IXANY);
+        options->c_cflag &= ~CRTSCTS;
+        options->c_iflag &= ~(IXON | IXOFF | IXANY);
         break;
     case UART_FLOW_SOFTWARE:
-        options.c_cflag &= ~CRTSCTS;
-        options.c_iflag |= (IXON | IXOFF | IXANY);
+        options->c_cflag &= ~CRTSCTS;
+        options->c_iflag |= (IXON | IXOFF | IXANY);
         break;
     case UART_FLOW_HARDWARE:
-        options.c_cflag |= CRTSCTS;
-        options.c_iflag &= ~(IXON | IXOFF | IXANY);
+        options->c_cflag |= CRTSCTS;
+        options->c_iflag &= ~(IXON | IXOFF | IXANY);
         break;
     default:
         error("invalid Flow control", 0);
         return -1;
     }
     
-    ret = tcsetattr(uart->fd, TCSANOW, &options);
+    return 0;
+}
+
+int uart_init_flow(struct _uart *uart)
+{
+    int ret;
     
-    if (ret == -1) {
-        error("tcsetattr() failed", 1);
-        return -1;
-    }
+    TRACE_ENTER(uart, TRACE_INIT_FLOW, uart->flow_ctrl);
+    ret = uart_reconf(uart, uart_conf_flow);
+    TRACE_RETURN(uart, TRACE_INIT_FLOW, uart->flow_ctrl, ret);
+}
+
+/* the settings applied on open are traced one by one, like later changes */
+static int uart_init_conf(struct _uart *uart, struct termios *options,
+                          int (*conf)(struct _uart *, struct termios *),
+                          int event, int value)
+{
+    int ret;
     
-    return 0;
+    TRACE_ENTER(uart, event, value);
+    ret = conf(uart, options);
+    TRACE_RETURN(uart, event, value, ret);
 }
 
 int uart_init(struct _uart *uart)
@@ -765,45 +829,61 @@ int uart_init(struct _uart *uart)
         return -1;
     }
     
+    /*
+     * all settings are applied with a single tcgetattr()/tcsetattr() pair,
+     * other backends check them on a scratch copy
+     */
+    if (uart->be->configure)
+        memset(&options, 0, sizeof(options));
+    else
+        ret = tcgetattr(uart->fd, &options);
+    
+    if (ret == -1) {
+        error("tcgetattr() failed", 1);
+        return -1;
+    }
+    
     /* set baud rate */
-    ret = uart_init_baud(uart);
+    ret = uart_init_conf(uart, &options, uart_conf_baud,
+                         TRACE_INIT_BAUD, uart->baud);
     
     if (ret == -1)
         return -1;
     
     /* set data bits */
-    ret = uart_init_databits(uart);
+    ret = uart_init_conf(uart, &options, uart_conf_databits,
+                         TRACE_INIT_DATABITS, uart->data_bits);
     
     if (ret == -1)
         return -1;
     
     /* set parity */
-    ret = uart_init_parity(uart);
+    ret = uart_init_conf(uart, &options, uart_conf_parity,
+                         TRACE_INIT_PARITY, uart->parity);
     
     if (ret == -1)
         return -1;
     
     /* set stop bits */
-    ret = uart_init_stopbits(uart);
+    ret = uart_init_conf(uart, &options, uart_conf_stopbits,
+                         TRACE_INIT_STOPBITS, uart->stop_bits);
     
     if (ret == -1)
         return -1;
     
     /* set flow control */
-    ret = uart_init_flow(uart);
+    ret = uart_init_conf(uart, &options, uart_conf_flow,
+                         TRACE_INIT_FLOW, uart->flow_ctrl);
     
     if (ret == -1)
         return -1;
     
-    ret = tcgetattr(uart->fd, &options);
+    if (uart->be->configure)
+        return uart->be->configure(uart);
     
-    if (ret == -1) {
-        error("tcgetattr() failed", 1);
-        return -1;
-    }
-    
-    /* set raw input mode */
+    /* set raw input mode, bytes pass unchanged (CR stays CR) */
     options.c_lflag &= ~(ICANON | ECHO | ECHOE | ISIG);
+    options.c_iflag &= ~(BRKINT | PARMRK | ISTRIP | INLCR | IGNCR | ICRNL);
     
     /* enable receiver and set local mode */
     options.c_cflag |= (CLOCAL | CREAD);
@@ -825,69 +905,295 @@ int uart_open(struct _uart *uart)
     int ret;
     int fd;
     
-    fd = open(uart->dev, O_RDWR | O_NOCTTY | O_NDELAY);
+    uart->be = backend_find(uart->dev);
+    fd = uart->be->open(uart, backend_name(uart));
     
-    if (fd == -1) {
-        error("open() failed", 1);
+    if (fd == -1)
         return -1;
-    }
     
     uart->fd = fd;
+    uart->id = atomic_fetch_add(&uart_next_id, 1) + 1;
     ret = uart_init(uart);
     
     if (ret == -1) {
-        close(fd);
+        uart->be->close(uart);
         return -1;
     }
     
+    /* the initial configuration does not count as reconfiguration */
+    stats_reset(uart);
+    icount_init(uart);
     return 0;
 }
 
+/*
+ * Open the device again after it was unplugged and apply the saved
+ * settings. The new descriptor takes over the number of the old one, so
+ * descriptors handed out by libUART_get_fd() stay valid. Messages queued
+ * while the device was gone are sent right away.
+ */
+int uart_reopen(struct _uart *uart)
+{
+    int ret = -1;
+    int fd;
+    
+    if (!(uart->be->flags & BACKEND_REOPEN)) {
+        error_code(UART_ERR_STATE, "UART backend cannot be reopened");
+        return -1;
+    }
+    
+    pthread_mutex_lock(&uart_reopen_mutex);
+    fd = uart->be->open(uart, backend_name(uart));
+    
+    if (fd == -1)
+        goto out;
+    
+    if (dup2(fd, uart->fd) == -1) {
+        error("dup2() failed", 1);
+        close(fd);
+        goto out;
+    }
+    
+    close(fd);
+    
+    if (uart_init(uart) == -1)
+        goto out;
+    
+    icount_init(uart);
+    
+    if (uart->rc)
+        atomic_store(&uart->rc->lost, 0);
+    
+    if (uart->reader && reader_resume(uart) == -1)
+        goto out;
+    
+    if (uart->mgr && mgr_resume(uart) == -1)
+        goto out;
+    
+    if (uart->txq && txq_drain(uart) == -1)
+        goto out;
+    
+    ret = 0;
+    
+out:
+    pthread_mutex_unlock(&uart_reopen_mutex);
+    return ret;
+}
+
+/*
+ * Held while the reader or the manager of a port is torn down, so a
+ * reopen running at the same time does not resume what is being freed.
+ */
+void uart_reopen_lock(void)
+{
+    pthread_mutex_lock(&uart_reopen_mutex);
+}
+
+void uart_reopen_unlock(void)
+{
+    pthread_mutex_unlock(&uart_reopen_mutex);
+}
+
 void uart_close(struct _uart *uart)
 {
-    close(uart->fd);
+    /* no reopen may start or be running once the teardown begins */
+    if (uart->hp)
+        hotplug_unwatch(uart);
+    
+    if (uart->rc)
+        reconnect_disable(uart);
+    
+    if (uart->bridge)
+        bridge_destroy(uart->bridge);
+    
+    if (uart->share)
+        share_destroy(uart->share);
+    
+    if (uart->mgr)
+        mgr_remove(uart);
+    
+    reader_stop(uart);
+    
+    /* the threads stopped above may have still looked at the state */
+    if (uart->rc)
+        reconnect_destroy(uart);
+    
+    txq_destroy(uart);
+    lat_destroy(uart);
+    cap_stop(uart);
+    uart->be->close(uart);
+    
+    if (uart->replay)
+        replay_destroy(uart->replay);
+    
     free(uart);
     uart = NULL;
 }
 
 int uart_send(struct _uart *uart, char *send_buf, int len)
 {
+    struct iovec iov;
     int ret;
     
-    ret = write(uart->fd, send_buf, len);
+    TRACE_ENTER(uart, TRACE_SEND, len);
+    iov.iov_base = send_buf;
+    iov.iov_len = len;
+    ret = uart->be->writev(uart, &iov, 1);
+    STATS_ADD(uart, write_calls, 1);
     
     if (ret == -1) {
+        /* nothing was sent, the caller may retry once the port is back */
+        if (uart->rc && RECONNECT_ERRNO(errno) && reconnect_lost(uart)) {
+            error_code(UART_ERR_IO, "UART device reconnecting");
+            TRACE_RETURN(uart, TRACE_SEND, len, 0);
+        }
+        
         error("write() failed", 1);
-        return -1;
+        TRACE_RETURN(uart, TRACE_SEND, len, -1);
     }
     
+    STATS_ADD(uart, tx_bytes, ret);
+    
+    if (CAP_ACTIVE(uart) && ret > 0)
+        cap_buf(uart, CAP_TX, send_buf, ret);
+    
     if (ret != len) {
-        error("could not send all bytes", 0);
-        return ret;
+        STATS_ADD(uart, short_writes, 1);
+        error_code(UART_ERR_IO, "could not send all bytes");
+        TRACE_RETURN(uart, TRACE_SEND, len, ret);
     }
     
-    return ret;
+    if (uart->lat)
+        lat_tx_done(uart);
+    
+    TRACE_RETURN(uart, TRACE_SEND, len, ret);
+}
+
+int uart_sendv(struct _uart *uart, const struct iovec *iov, int cnt)
+{
+    ssize_t ret;
+    size_t len = 0;
+    int i;
+    
+    TRACE_ENTER(uart, TRACE_SENDV, cnt);
+    ret = uart->be->writev(uart, iov, cnt);
+    STATS_ADD(uart, write_calls, 1);
+    
+    if (ret == -1) {
+        /* output buffer full, not an error for queued transmission */
+        if (errno == EAGAIN) {
+            STATS_ADD(uart, short_writes, 1);
+            TRACE_RETURN(uart, TRACE_SENDV, cnt, 0);
+        }
+        
+        /* same for a lost device, the queue is sent after the reopen */
+        if (uart->rc && RECONNECT_ERRNO(errno) && reconnect_lost(uart))
+            TRACE_RETURN(uart, TRACE_SENDV, cnt, 0);
+        
+        error("writev() failed", 1);
+        TRACE_RETURN(uart, TRACE_SENDV, cnt, -1);
+    }
+    
+    for (i = 0; i < cnt; i++)
+        len += iov[i].iov_len;
+    
+    STATS_ADD(uart, tx_bytes, ret);
+    
+    if (CAP_ACTIVE(uart) && ret > 0)
+        cap_record(uart, CAP_TX, iov, cnt, ret);
+    
+    if ((size_t) ret != len)
+        STATS_ADD(uart, short_writes, 1);
+    else if (uart->lat)
+        lat_tx_done(uart);
+    
+    TRACE_RETURN(uart, TRACE_SENDV, cnt, (int) ret);
 }
 
 int uart_recv(struct _uart *uart, char *recv_buf, int len)
 {
+    return uart_recv_ts(uart, recv_buf, len, NULL);
+}
+
+/* tells a hung up device from an idle one after read() returned 0 */
+static int uart_hung_up(struct _uart *uart)
+{
+    struct pollfd pfd;
+    
+    pfd.fd = uart->fd;
+    pfd.events = POLLIN;
+    pfd.revents = 0;
+    
+    if (poll(&pfd, 1, 0) == -1)
+        return 0;
+    
+    return (pfd.revents & (POLLHUP | POLLERR)) != 0;
+}
+
+/* 'ts' is only set if data was received */
+int uart_recv_ts(struct _uart *uart, char *recv_buf, int len,
+                 struct uart_rx_ts *ts)
+{
+    long long now;
+    int pending;
     int ret = 0;
     
-    ret = read(uart->fd, recv_buf, len);
+    TRACE_ENTER(uart, TRACE_RECV, len);
+    ret = uart->be->read(uart, recv_buf, len);
+    
+    if (ts && ret > 0) {
+        now = stats_raw_ns();
+        
+        /* a full buffer may leave younger bytes behind */
+        if (ret < len || uart->be->bytes_available(uart, &pending) == -1)
+            pending = 0;
+        
+        uart_rx_ts_set(uart, ts, now, ret + pending);
+    }
+    
+    STATS_ADD(uart, read_calls, 1);
     
     if (ret == -1) {
+        /* the port is non-blocking, no data is not an error */
+        if (errno == EAGAIN) {
+            STATS_ADD(uart, empty_reads, 1);
+            TRACE_RETURN(uart, TRACE_RECV, len, 0);
+        }
+        
+        /* no data until the device is back */
+        if (uart->rc && RECONNECT_ERRNO(errno) && reconnect_lost(uart))
+            TRACE_RETURN(uart, TRACE_RECV, len, 0);
+        
         error("read() failed", 1);
-        return -1;
+        TRACE_RETURN(uart, TRACE_RECV, len, -1);
+    }
+    
+    if (ret == 0) {
+        STATS_ADD(uart, empty_reads, 1);
+        
+        /* a hung up tty reads as end of file, wait for the device */
+        if (uart->rc && uart_hung_up(uart))
+            reconnect_lost(uart);
+        
+        TRACE_RETURN(uart, TRACE_RECV, len, 0);
     }
+    
+    STATS_ADD(uart, rx_bytes, ret);
+    
+    if (CAP_ACTIVE(uart))
+        cap_buf(uart, CAP_RX, recv_buf, ret);
+    
+    if (uart->lat)
+        lat_rx(uart);
 
-    return ret;
+    TRACE_RETURN(uart, TRACE_RECV, len, ret);
 }
 
 int uart_flush(struct _uart *uart)
 {
     int ret = 0;
     
-    ret = fsync(uart->fd);
+    ret = uart->be->flush(uart);
     
     if (ret == -1) {
         error("fsync() failed", 1);
@@ -902,11 +1208,12 @@ int uart_set_pin(struct _uart *uart, int pin, int state)
     int ret;
     int status;
     
-    ret = ioctl(uart->fd, TIOCMGET, &status);
+    TRACE_ENTER(uart, TRACE_SET_PIN, pin);
+    ret = uart->be->get_pins(uart, &status);
     
     if (ret == -1) {
         error("ioctl() failed", 1);
-        return -1;
+        TRACE_RETURN(uart, TRACE_SET_PIN, pin, -1);
     }
     
     switch (pin) {
@@ -924,17 +1231,17 @@ int uart_set_pin(struct _uart *uart, int pin, int state)
         break;
     default:
         error("invalid pin", 0);
-        return -1;
+        TRACE_RETURN(uart, TRACE_SET_PIN, pin, -1);
     }
     
-    ioctl(uart->fd, TIOCMSET, status);
+    ret = uart->be->set_pins(uart, status);
     
     if (ret == -1) {
         error("ioctl() failed", 1);
-        return -1;
+        TRACE_RETURN(uart, TRACE_SET_PIN, pin, -1);
     }
     
-    return 0;
+    TRACE_RETURN(uart, TRACE_SET_PIN, pin, 0);
 }
 
 int uart_get_pin(struct _uart *uart, int pin, int *state)
@@ -942,11 +1249,12 @@ int uart_get_pin(struct _uart *uart, int pin, int *state)
     int ret = 0;
     int status;
     
-    ioctl(uart->fd, TIOCMGET, &status);
+    TRACE_ENTER(uart, TRACE_GET_PIN, pin);
+    ret = uart->be->get_pins(uart, &status);
     
     if (ret == -1) {
         error("ioctl() failed", 1);
-        return -1;
+        TRACE_RETURN(uart, TRACE_GET_PIN, pin, -1);
     }
     
     switch (pin) {
@@ -976,24 +1284,26 @@ int uart_get_pin(struct _uart *uart, int pin, int *state)
         break;
     default:
         error("invalid pin", 0);
-        return -1;
+        TRACE_RETURN(uart, TRACE_GET_PIN, pin, -1);
     }
     
     (*state) = ret;
-    return 0;
+    TRACE_RETURN(uart, TRACE_GET_PIN, pin, 0);
 }
 
 int uart_get_bytes(struct _uart *uart, int *bytes)
 {
-    int ret = 0;
+    int ret;
+    int num = 0;
     
-    ioctl(uart->fd, FIONREAD, &ret);
+    TRACE_ENTER(uart, TRACE_GET_BYTES, 0);
+    ret = uart->be->bytes_available(uart, &num);
     
     if (ret == -1) {
         error("ioctl() failed", 1);
-        return -1;
+        TRACE_RETURN(uart, TRACE_GET_BYTES, 0, -1);
     }
     
-    (*bytes) = ret;
-    return 0;
+    (*bytes) = num;
+    TRACE_RETURN(uart, TRACE_GET_BYTES, 0, 0);
 }
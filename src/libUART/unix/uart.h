@@ -19,19 +19,58 @@
 #ifndef LIBUART_UNIX_UART_H
 #define LIBUART_UNIX_UART_H
 
+#include <sys/uio.h>
+
+#include "stats.h"
+#include "icount.h"
+
 #define DEV_NAME_LEN        256
 
+struct uart_backend;
+struct uart_rx_ts;
+struct reader;
+struct txq;
+struct latency;
+struct capture;
+struct replay;
+struct mgr_port;
+struct hotplug;
+struct reconnect;
+struct _uart_bridge;
+struct _uart_share;
+
 struct _uart {
     int fd;
+    const struct uart_backend *be;
+    void *be_priv;
+    atomic_int modem;           /* TIOCM_* lines of emulating backends */
+    unsigned int id;
     char dev[DEV_NAME_LEN];
     int baud;
     int data_bits;
     int stop_bits;
     int parity;
     int flow_ctrl;
+    struct reader *reader;
+    struct txq *txq;
+    struct stats stats;
+    struct latency *lat;
+    struct icount icount;
+    _Atomic(struct capture *) cap;
+    atomic_int cap_users;       /* records in progress, see cap_stop() */
+    struct replay *replay;
+    struct mgr_port *mgr;
+    struct hotplug *hp;
+    struct reconnect *rc;
+    struct _uart_bridge *bridge;
+    struct _uart_share *share;
 };
 
 extern int uart_baud_valid(int value);
+extern int uart_char_bits(struct _uart *uart);
+extern long long uart_char_ns(struct _uart *uart);
+extern void uart_rx_ts_set(struct _uart *uart, struct uart_rx_ts *ts,
+                           long long rx_ns, int len);
 extern int uart_init_baud(struct _uart *uart);
 extern int uart_init_databits(struct _uart *uart);
 extern int uart_init_parity(struct _uart *uart);
@@ -39,9 +78,15 @@ extern int uart_init_stopbits(struct _uart *uart);
 extern int uart_init_flow(struct _uart *uart);
 extern int uart_init(struct _uart *uart);
 extern int uart_open(struct _uart *uart);
+extern int uart_reopen(struct _uart *uart);
+extern void uart_reopen_lock(void);
+extern void uart_reopen_unlock(void);
 extern void uart_close(struct _uart *uart);
 extern int uart_send(struct _uart *uart, char *send_buf, int len);
+extern int uart_sendv(struct _uart *uart, const struct iovec *iov, int cnt);
 extern int uart_recv(struct _uart *uart, char *recv_buf, int len);
+extern int uart_recv_ts(struct _uart *uart, char *recv_buf, int len,
+                        struct uart_rx_ts *ts);
 extern int uart_flush(struct _uart *uart);
 extern int uart_set_pin(struct _uart *uart, int pin, int state);
 extern int uart_get_pin(struct _uart *uart, int pin, int *state);
@@ -19,6 +19,8 @@
 #ifndef LIBUART_UTIL_H
 #define LIBUART_UTIL_H
 
+#define CACHE_LINE_SIZE     64
+
 extern int enum_contains(int enum_values[], int len, int value);
 
 #endif
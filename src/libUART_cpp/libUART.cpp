@@ -5,9 +5,9 @@
  * Project  : libUART - libUART_cpp
  * Author   : Copyright (C) 2018-1019 Johannes Krottmayer <krjdev@gmail.com>
  * Created  : 2019-11-20
- * Modified : 
- * Revised  : 
- * Version  : 0.1.0.0
+ * Modified : 2026-10-19
+ * Revised  :
+ * Version  : 0.2.0.0
  * License  : ISC (see file LICENSE.txt)
  *
  * NOTE: This code is currently below version 1.0, and therefore is considered
@@ -16,7 +16,312 @@
  *
  */
 
+#include <cerrno>
+#include <cstring>
+#include <chrono>
+#include <string_view>
+#include <thread>
+
 #include <libUART.h>
 
 #include "libUART.hpp"
 
+/* bytes requested from the port per read */
+#define RX_CHUNK        256
+
+libUART::libUART(void)
+    : libUART(nullptr)
+{
+}
+
+libUART::libUART(std::pmr::memory_resource *mr)
+    : uart(nullptr),
+      pool(),
+      mr(mr ? mr : &pool),
+      rx(this->mr),
+      rx_pos(0)
+{
+}
+
+libUART::~libUART(void)
+{
+    Close();
+}
+
+int libUART::Open(const char *dev, int baud, const char *opt)
+{
+    if (uart)
+        Close();
+
+    uart = libUART_open(dev, baud, opt);
+
+    if (!uart)
+        return -1;
+
+    return 0;
+}
+
+void libUART::Close(void)
+{
+    if (!uart)
+        return;
+
+    libUART_close(uart);
+    uart = nullptr;
+    rx.clear();
+    rx_pos = 0;
+}
+
+int libUART::Send(const char *buf, int len)
+{
+    return libUART_send(uart, const_cast<char *>(buf), len);
+}
+
+int libUART::Send(const std::pmr::string &str)
+{
+    return Send(str.data(), static_cast<int>(str.size()));
+}
+
+int libUART::Recv(char *buf, int len)
+{
+    std::size_t avail = rx.size() - rx_pos;
+    std::size_t n;
+
+    if (avail == 0)
+        return libUART_recv(uart, buf, len);
+
+    /* hand out data already pulled in by ReadLine() and friends first */
+    n = avail < static_cast<std::size_t>(len) ? avail : len;
+    std::memcpy(buf, rx.data() + rx_pos, n);
+    Consume(n);
+    return static_cast<int>(n);
+}
+
+int libUART::Fill(void)
+{
+    std::size_t used;
+    int ret;
+
+    /* drop consumed data before growing the buffer */
+    if (rx_pos > 0 && rx_pos >= rx.size() / 2) {
+        rx.erase(rx.begin(), rx.begin() + rx_pos);
+        rx_pos = 0;
+    }
+
+    used = rx.size();
+    rx.resize(used + RX_CHUNK);
+    ret = libUART_recv(uart, rx.data() + used, RX_CHUNK);
+
+    if (ret == -1) {
+        rx.resize(used);
+        return errno == EAGAIN ? 0 : -1;
+    }
+
+    rx.resize(used + ret);
+    return ret;
+}
+
+const char *libUART::Find(char delim) const
+{
+    if (rx_pos == rx.size())
+        return nullptr;
+
+    return static_cast<const char *>(
+        std::memchr(rx.data() + rx_pos, delim, rx.size() - rx_pos));
+}
+
+void libUART::Consume(std::size_t len)
+{
+    rx_pos += len;
+
+    if (rx_pos == rx.size()) {
+        rx.clear();
+        rx_pos = 0;
+    }
+}
+
+int libUART::ReadLine(std::pmr::string &line)
+{
+    const char *begin;
+    const char *end;
+    std::size_t len;
+
+    if (!uart)
+        return -1;
+
+    end = Find('\n');
+
+    if (!end) {
+        if (Fill() == -1)
+            return -1;
+
+        end = Find('\n');
+
+        if (!end)
+            return 0;
+    }
+
+    begin = rx.data() + rx_pos;
+    len = end - begin;
+
+    if (len > 0 && begin[len - 1] == '\r')
+        line.assign(begin, len - 1);
+    else
+        line.assign(begin, len);
+
+    Consume(len + 1);
+    return 1;
+}
+
+int libUART::ReadFrame(std::pmr::vector<char> &frame, char delim)
+{
+    const char *begin;
+    const char *end;
+
+    if (!uart)
+        return -1;
+
+    end = Find(delim);
+
+    if (!end) {
+        if (Fill() == -1)
+            return -1;
+
+        end = Find(delim);
+
+        if (!end)
+            return 0;
+    }
+
+    begin = rx.data() + rx_pos;
+    frame.assign(begin, end);
+    Consume(end - begin + 1);
+    return 1;
+}
+
+int libUART::Command(const char *cmd, const char *ok, const char *err,
+                     long timeout_ms, std::pmr::string &resp, int cls)
+{
+    std::chrono::steady_clock::time_point deadline;
+    std::string_view data;
+    std::size_t pos_ok;
+    std::size_t pos_err;
+    std::size_t len;
+    int ret;
+
+    if (!uart)
+        return -1;
+
+    if (cls >= 0 && libUART_lat_begin(uart, cls) == -1)
+        return -1;
+
+    if (libUART_puts(uart, const_cast<char *>(cmd)) == -1)
+        return -1;
+
+    deadline = std::chrono::steady_clock::now() +
+               std::chrono::milliseconds(timeout_ms);
+
+    while (1) {
+        data = std::string_view(rx.data() + rx_pos, rx.size() - rx_pos);
+        pos_ok = data.find(ok);
+        pos_err = data.find(err);
+
+        if (pos_ok != std::string_view::npos ||
+            pos_err != std::string_view::npos) {
+            if (pos_ok <= pos_err) {
+                len = pos_ok + std::strlen(ok);
+                ret = 1;
+            } else {
+                len = pos_err + std::strlen(err);
+                ret = 0;
+            }
+
+            resp.assign(data.data(), len);
+            Consume(len);
+
+            if (cls >= 0)
+                libUART_lat_end(uart);
+
+            return ret;
+        }
+
+        if (std::chrono::steady_clock::now() >= deadline)
+            return -1;
+
+        ret = Fill();
+
+        if (ret == -1)
+            return -1;
+
+        if (ret == 0)
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
+
+libUART::LineDecoder::LineDecoder(char delim)
+    : delim(delim)
+{
+}
+
+std::size_t libUART::LineDecoder::operator()(char *data, std::size_t len,
+                                             std::string_view &frame) const
+{
+    const char *end;
+    std::size_t n;
+
+    end = static_cast<const char *>(std::memchr(data, delim, len));
+
+    if (!end)
+        return 0;
+
+    n = end - data;
+
+    if (delim == '\n' && n > 0 && data[n - 1] == '\r')
+        frame = std::string_view(data, n - 1);
+    else
+        frame = std::string_view(data, n);
+
+    return n + 1;
+}
+
+std::size_t libUART::CobsDecoder::operator()(char *data, std::size_t len,
+                                             std::string_view &frame) const
+{
+    const char *end;
+    std::size_t in = 0;
+    std::size_t out = 0;
+    std::size_t n;
+    unsigned char code;
+    unsigned char i;
+
+    end = static_cast<const char *>(std::memchr(data, '\0', len));
+
+    if (!end)
+        return 0;
+
+    n = end - data;
+
+    /* decode in place, the output never overtakes the input */
+    while (in < n) {
+        code = static_cast<unsigned char>(data[in++]);
+
+        for (i = 1; i < code && in < n; i++)
+            data[out++] = data[in++];
+
+        if (code < 0xFF && in < n)
+            data[out++] = '\0';
+    }
+
+    frame = std::string_view(data, out);
+    return n + 1;
+}
+
+std::pmr::memory_resource *libUART::GetResource(void) const
+{
+    return mr;
+}
+
+uart_t *libUART::GetHandle(void) const
+{
+    return uart;
+}
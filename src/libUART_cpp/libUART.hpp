@@ -5,9 +5,9 @@
  * Project  : libUART - libUART_cpp
  * Author   : Copyright (C) 2018-1019 Johannes Krottmayer <krjdev@gmail.com>
  * Created  : 2019-11-20
- * Modified : 
- * Revised  : 
- * Version  : 0.1.0.0
+ * Modified : 2026-10-19
+ * Revised  :
+ * Version  : 0.2.0.0
  * License  : ISC (see file LICENSE.txt)
  *
  * NOTE: This code is currently below version 1.0, and therefore is considered
@@ -19,15 +19,296 @@
 #ifndef LIBUART_LIBUART_HPP
 #define LIBUART_LIBUART_HPP
 
+#include <chrono>
+#include <cstddef>
+#include <iterator>
+#include <memory_resource>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+#if __cplusplus > 201703L
+#include <ranges>
+#endif
+
+#include <libUART.h>
+
+/*
+ * C++ wrapper around an uart_t object.
+ *
+ * Every buffer owned or filled by the wrapper (receive buffer, lines,
+ * frames, AT responses) is allocated from a std::pmr::memory_resource.
+ * Pass one to the constructor to share it with the rest of the
+ * application, otherwise each port uses its own unsynchronized pool
+ * resource. The wrapper itself is not thread-safe, so neither is the
+ * default resource.
+ */
 class libUART {
 public:
+    /*
+     * Decoders split the receive buffer into frames for Frames(). They
+     * are called with the unconsumed data and return the number of
+     * bytes making up the first complete frame (0 if there is none
+     * yet), storing the decoded frame in 'frame'. Decoding may happen
+     * in place, 'frame' may point into 'data'.
+     */
+    class LineDecoder {
+    public:
+        explicit LineDecoder(char delim = '\n');
+        std::size_t operator()(char *data, std::size_t len,
+                               std::string_view &frame) const;
+
+    private:
+        char delim;
+    };
+
+    /* Consistent Overhead Byte Stuffing, frames delimited by 0x00 */
+    class CobsDecoder {
+    public:
+        std::size_t operator()(char *data, std::size_t len,
+                               std::string_view &frame) const;
+    };
+
+    /*
+     * Lazy input range over the frames received by a port. Each element
+     * is a view into the port's receive buffer and stays valid until
+     * the iterator is incremented. Iteration ends when no complete
+     * frame arrived within the timeout (0 = only data already
+     * available, -1 = wait forever) or the port reports an error.
+     */
+    template <typename Decoder>
+    class FrameRange
+#if __cplusplus > 201703L
+        : public std::ranges::view_base
+#endif
+    {
+    public:
+        struct sentinel {
+        };
+
+        class iterator {
+        public:
+            using iterator_category = std::input_iterator_tag;
+            using iterator_concept = std::input_iterator_tag;
+            using value_type = std::string_view;
+            using difference_type = std::ptrdiff_t;
+            using pointer = const std::string_view *;
+            using reference = const std::string_view &;
+
+            iterator(void) : range(nullptr) {}
+            explicit iterator(FrameRange *range) : range(range) {}
+
+            reference operator*(void) const { return range->frame; }
+            pointer operator->(void) const { return &range->frame; }
+            iterator &operator++(void) { range->Next(); return *this; }
+            void operator++(int) { range->Next(); }
+
+            friend bool operator==(const iterator &it, sentinel)
+            {
+                return it.AtEnd();
+            }
+
+            friend bool operator!=(const iterator &it, sentinel s)
+            {
+                return !(it == s);
+            }
+
+            friend bool operator==(sentinel s, const iterator &it)
+            {
+                return it == s;
+            }
+
+            friend bool operator!=(sentinel s, const iterator &it)
+            {
+                return !(it == s);
+            }
+
+        private:
+            bool AtEnd(void) const { return !range || range->done; }
+
+            FrameRange *range;
+        };
+
+        FrameRange(libUART *port, Decoder dec, long timeout_ms)
+            : port(port), dec(std::move(dec)), timeout_ms(timeout_ms),
+              used(0), started(false), done(false)
+        {
+        }
+
+        FrameRange(FrameRange &&other)
+            : port(other.port), dec(std::move(other.dec)),
+              timeout_ms(other.timeout_ms), frame(other.frame),
+              used(other.used), started(other.started), done(other.done)
+        {
+            other.port = nullptr;
+            other.used = 0;
+        }
+
+        FrameRange &operator=(FrameRange &&other)
+        {
+            if (this != &other) {
+                Release();
+                port = other.port;
+                dec = std::move(other.dec);
+                timeout_ms = other.timeout_ms;
+                frame = other.frame;
+                used = other.used;
+                started = other.started;
+                done = other.done;
+                other.port = nullptr;
+                other.used = 0;
+            }
+
+            return *this;
+        }
+
+        FrameRange(const FrameRange &) = delete;
+        FrameRange &operator=(const FrameRange &) = delete;
+
+        ~FrameRange(void)
+        {
+            Release();
+        }
+
+        iterator begin(void)
+        {
+            if (!started) {
+                started = true;
+                Next();
+            }
+
+            return iterator(this);
+        }
+
+        sentinel end(void)
+        {
+            return sentinel();
+        }
+
+    private:
+        /* hand the bytes of the current frame back to the port */
+        void Release(void)
+        {
+            if (port && used)
+                port->Consume(used);
+
+            used = 0;
+        }
+
+        void Next(void)
+        {
+            std::chrono::steady_clock::time_point deadline;
+            std::size_t n;
+            int ret;
+
+            if (!port) {
+                done = true;
+                return;
+            }
+
+            Release();
+            deadline = std::chrono::steady_clock::now() +
+                       std::chrono::milliseconds(timeout_ms);
+
+            while (1) {
+                if (port->rx_pos < port->rx.size()) {
+                    n = dec(port->rx.data() + port->rx_pos,
+                            port->rx.size() - port->rx_pos, frame);
+
+                    if (n > 0) {
+                        used = n;
+                        return;
+                    }
+                }
+
+                ret = port->Fill();
+
+                if (ret == -1) {
+                    done = true;
+                    return;
+                }
+
+                if (ret > 0)
+                    continue;
+
+                if (timeout_ms >= 0 &&
+                    std::chrono::steady_clock::now() >= deadline) {
+                    done = true;
+                    return;
+                }
+
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+        }
+
+        libUART *port;
+        Decoder dec;
+        long timeout_ms;
+        std::string_view frame;
+        std::size_t used;
+        bool started;
+        bool done;
+    };
+
     libUART(void);
+    explicit libUART(std::pmr::memory_resource *mr);
     ~libUART(void);
-    int Send();
-    int Recv();
-    
+    libUART(const libUART &) = delete;
+    libUART &operator=(const libUART &) = delete;
+
+    int Open(const char *dev, int baud, const char *opt);
+    void Close(void);
+    int Send(const char *buf, int len);
+    int Send(const std::pmr::string &str);
+    int Recv(char *buf, int len);
+
+    /*
+     * Return 1 and store the next line (without the line terminator)
+     * in 'line' once a complete line has been received, 0 if no
+     * complete line is buffered yet and -1 on error. 'line' allocates
+     * from its own allocator, construct it with GetResource() to keep
+     * the port's allocations on the port's resource.
+     */
+    int ReadLine(std::pmr::string &line);
+
+    /* Same as ReadLine(), but for frames terminated by 'delim'. */
+    int ReadFrame(std::pmr::vector<char> &frame, char delim);
+
+    /*
+     * Send an AT command and collect the response until 'ok' or 'err'
+     * is received. Return 1 on 'ok', 0 on 'err' and -1 on error or
+     * timeout. With 'cls' >= 0 the round trip is recorded in the port's
+     * latency histograms for that command class (see
+     * libUART_set_latency()).
+     */
+    int Command(const char *cmd, const char *ok, const char *err,
+                long timeout_ms, std::pmr::string &resp, int cls = -1);
+
+    template <typename Decoder>
+    FrameRange<Decoder> Frames(Decoder dec, long timeout_ms = 0)
+    {
+        return FrameRange<Decoder>(this, std::move(dec), timeout_ms);
+    }
+
+    FrameRange<LineDecoder> Lines(long timeout_ms = 0)
+    {
+        return Frames(LineDecoder(), timeout_ms);
+    }
+
+    std::pmr::memory_resource *GetResource(void) const;
+    uart_t *GetHandle(void) const;
+
 private:
-    
+    int Fill(void);
+    const char *Find(char delim) const;
+    void Consume(std::size_t len);
+
+    uart_t *uart;
+    std::pmr::unsynchronized_pool_resource pool;
+    std::pmr::memory_resource *mr;
+    std::pmr::vector<char> rx;
+    std::size_t rx_pos;
 };
 
 #endif